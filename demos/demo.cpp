@@ -121,6 +121,8 @@ void DemoText::setup_frame() {
     auto styles_ = ksg::styles::construct_system_styles();
     styles_[ksg::styles::k_global_font] = ksg::styles::load_font("font.ttf");
     styles_[Frame::k_border_size] = ksg::StylesField(0.f);
+    // rasterize glyphs now, rather than on first use
+    ksg::styles::prewarm_glyphs(styles_);
 
     m_embeded_frame.setup_frame();
 
@@ -0,0 +1,151 @@
+// Stress test for ksg::EventQueue: one thread pushes a numbered stream of
+// events while this thread pops/drains them, checking that every event
+// arrives exactly once and in order.
+// g++ -std=c++17 event_queue_stress.cpp -lksg -lcommon -lsfml-graphics -lsfml-window -lsfml-system -lpthread -I../inc -I../lib/cul/inc -o event_queue_stress
+#include <ksg/EventQueue.hpp>
+#include <ksg/Widget.hpp>
+
+#include <SFML/Window/Event.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <cassert>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const int k_event_count = 1000000;
+
+sf::Event make_numbered_event(int n) {
+    sf::Event event;
+    event.type = sf::Event::MouseMoved;
+    event.mouseMove.x = n;
+    event.mouseMove.y = -n;
+    return event;
+}
+
+// checks the numbering of everything it is sent
+class CountingWidget final : public ksg::Widget {
+public:
+    void process_event(const sf::Event & event) override {
+        assert(event.type == sf::Event::MouseMoved);
+        assert(event.mouseMove.x == m_next);
+        assert(event.mouseMove.y == -m_next);
+        (void)event;
+        ++m_next;
+    }
+
+    void set_location(float, float) override {}
+
+    VectorF location() const override { return VectorF(); }
+
+    float width() const override { return 0.f; }
+
+    float height() const override { return 0.f; }
+
+    void set_style(const ksg::StyleMap &) override {}
+
+    int next_expected() const { return m_next; }
+
+    void set_next_expected(int n) { m_next = n; }
+
+private:
+    void draw(sf::RenderTarget &, sf::RenderStates) const override {}
+
+    int m_next = 0;
+};
+
+void run_producer(ksg::EventQueue & queue, std::atomic_bool & full_seen) {
+    for (int i = 0; i != k_event_count; ++i) {
+        auto event = make_numbered_event(i);
+        while (!queue.push(event)) {
+            full_seen = true;
+            std::this_thread::yield();
+        }
+    }
+}
+
+// alternates single pops with drains, so both consumer paths are exercised
+double run_consumer(ksg::EventQueue & queue) {
+    CountingWidget widget;
+    auto start = Clock::now();
+    sf::Event event;
+    bool use_pop = false;
+    while (widget.next_expected() != k_event_count) {
+        bool got_any = false;
+        if (use_pop) {
+            got_any = queue.pop(event);
+            if (got_any) widget.process_event(event);
+        } else {
+            got_any = queue.drain_into(widget) != 0;
+        }
+        // lets the producer run when both share a core
+        if (!got_any) std::this_thread::yield();
+        use_pop = !use_pop;
+    }
+    assert(queue.is_empty());
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void test_single_threaded() {
+    ksg::EventQueue queue(5);
+    // capacity is rounded up to a power of two
+    assert(queue.capacity() == 8);
+    assert(queue.is_empty());
+    for (int i = 0; i != 8; ++i) {
+        bool pushed = queue.push(make_numbered_event(i));
+        assert(pushed);
+        (void)pushed;
+    }
+    // full queues drop rather than overwrite
+    assert(!queue.push(make_numbered_event(8)));
+    assert(queue.size() == 8);
+
+    CountingWidget widget;
+    sf::Event event;
+    bool popped = queue.pop(event);
+    assert(popped);
+    (void)popped;
+    widget.process_event(event);
+    auto drained = queue.drain_into(widget);
+    assert(drained == 7);
+    (void)drained;
+    assert(widget.next_expected() == 8);
+    assert(queue.is_empty());
+
+    // positions wrap around the ring many times
+    widget.set_next_expected(100);
+    for (int i = 100; i != 1100; ++i) {
+        queue.push(make_numbered_event(i));
+        if (i % 3 == 0) queue.drain_into(widget);
+    }
+    queue.drain_into(widget);
+    assert(widget.next_expected() == 1100);
+}
+
+} // end of <anonymous> namespace
+
+int main() {
+    test_single_threaded();
+
+    for (std::size_t capacity : { std::size_t(16), ksg::EventQueue::k_default_capacity }) {
+        ksg::EventQueue queue(capacity);
+        std::atomic_bool full_seen(false);
+        std::thread producer([&queue, &full_seen]()
+            { run_producer(queue, full_seen); });
+        double secs = run_consumer(queue);
+        producer.join();
+
+        std::cout << "capacity " << queue.capacity() << ": " << k_event_count
+                  << " events in " << secs << "s ("
+                  << (double(k_event_count) / secs / 1000000.)
+                  << " million/s)" << (full_seen ? ", producer hit a full queue" : "")
+                  << std::endl;
+    }
+    std::cout << "All EventQueue tests passed." << std::endl;
+    return 0;
+}
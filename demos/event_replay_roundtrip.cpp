@@ -0,0 +1,212 @@
+// Round trip test for ksg::EventRecorder and ksg::EventPlayer: a stream of
+// events is recorded to file, loaded back and replayed, and the widget that
+// receives the replay must see exactly what the recorded widget saw.
+// g++ -std=c++17 event_replay_roundtrip.cpp -lksg -lcommon -lsfml-graphics -lsfml-window -lsfml-system -I../inc -I../lib/cul/inc -o event_replay_roundtrip
+#include <ksg/EventRecorder.hpp>
+#include <ksg/Widget.hpp>
+
+#include <SFML/Window/Event.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include <cassert>
+#include <cstdio>
+
+namespace {
+
+using Event = sf::Event;
+
+constexpr const auto * k_recording_filename = ".roundtrip.ksgevents";
+constexpr const auto * k_truncated_filename = ".truncated.ksgevents";
+
+class LoggingWidget final : public ksg::Widget {
+public:
+    void process_event(const Event & event) override
+        { m_events.push_back(event); }
+
+    void set_location(float, float) override {}
+
+    VectorF location() const override { return VectorF(); }
+
+    float width() const override { return 0.f; }
+
+    float height() const override { return 0.f; }
+
+    void set_style(const ksg::StyleMap &) override {}
+
+    const std::vector<Event> & events() const { return m_events; }
+
+private:
+    void draw(sf::RenderTarget &, sf::RenderStates) const override {}
+
+    std::vector<Event> m_events;
+};
+
+std::vector<Event> make_event_stream();
+
+bool events_equal(const Event &, const Event &);
+
+bool streams_equal(const std::vector<Event> & a, const std::vector<Event> & b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i != a.size(); ++i) {
+        if (!events_equal(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+std::vector<char> read_whole_file(const char * filename) {
+    std::ifstream in(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in),
+                             std::istreambuf_iterator<char>());
+}
+
+} // end of <anonymous> namespace
+
+int main() {
+    const auto stream = make_event_stream();
+
+    LoggingWidget recorded_widget;
+    {
+    ksg::EventRecorder recorder(recorded_widget, k_recording_filename);
+    for (const auto & event : stream) recorder.process_event(event);
+    assert(recorder.recorded_count() == stream.size());
+    recorder.flush();
+    }
+    // the recorder passes everything on unchanged
+    assert(streams_equal(recorded_widget.events(), stream));
+
+    ksg::EventPlayer player;
+    bool loaded = player.load_from_file(k_recording_filename);
+    assert(loaded);
+    assert(player.events().size() == stream.size());
+    for (std::size_t i = 1; i < player.events().size(); ++i) {
+        assert(player.events()[i - 1].time <= player.events()[i].time);
+    }
+
+    LoggingWidget replayed_widget;
+    auto times = player.replay(replayed_widget);
+    assert(times.size() == stream.size());
+    assert(streams_equal(replayed_widget.events(), stream));
+    for (std::size_t i = 0; i != times.size(); ++i) {
+        assert(times[i].type == stream[i].type);
+    }
+
+    // a recording cut short keeps every complete event
+    auto bytes = read_whole_file(k_recording_filename);
+    {
+    std::ofstream out(k_truncated_filename, std::ios::binary);
+    out.write(bytes.data(), std::streamsize(bytes.size() - 1));
+    }
+    loaded = player.load_from_file(k_truncated_filename);
+    assert(loaded);
+    assert(player.events().size() == stream.size() - 1);
+
+    // anything else is rejected, and leaves the player empty
+    {
+    std::ofstream out(k_truncated_filename, std::ios::binary);
+    out.write("not a recording", 15);
+    }
+    loaded = player.load_from_file(k_truncated_filename);
+    assert(!loaded);
+    assert(player.events().empty());
+    loaded = player.load_from_file(".no-such-file.ksgevents");
+    assert(!loaded);
+    (void)loaded;
+
+    std::remove(k_recording_filename);
+    std::remove(k_truncated_filename);
+    std::cout << "Recorded and replayed " << stream.size()
+              << " events, all matched." << std::endl;
+    return 0;
+}
+
+namespace {
+
+std::vector<Event> make_event_stream() {
+    std::vector<Event> rv;
+    Event event;
+
+    event.type = Event::Resized;
+    event.size.width  = 1920;
+    event.size.height = 1080;
+    rv.push_back(event);
+
+    event.type = Event::GainedFocus;
+    rv.push_back(event);
+
+    for (int i = -300; i < 3000; i += 97) {
+        event.type = Event::MouseMoved;
+        event.mouseMove.x = i;
+        event.mouseMove.y = 2*i - 5;
+        rv.push_back(event);
+    }
+
+    for (auto type : { Event::MouseButtonPressed, Event::MouseButtonReleased }) {
+        event.type = type;
+        event.mouseButton.button = sf::Mouse::Right;
+        event.mouseButton.x = 12;
+        event.mouseButton.y = -4;
+        rv.push_back(event);
+    }
+
+    event.type = Event::MouseWheelScrolled;
+    event.mouseWheelScroll.wheel = sf::Mouse::VerticalWheel;
+    event.mouseWheelScroll.delta = -1.25f;
+    event.mouseWheelScroll.x = 40;
+    event.mouseWheelScroll.y = 41;
+    rv.push_back(event);
+
+    for (auto type : { Event::KeyPressed, Event::KeyReleased }) {
+        event.type = type;
+        event.key.code    = sf::Keyboard::Tab;
+        event.key.alt     = false;
+        event.key.control = true;
+        event.key.shift   = type == Event::KeyPressed;
+        event.key.system  = false;
+        rv.push_back(event);
+    }
+
+    for (sf::Uint32 c : { sf::Uint32('a'), sf::Uint32(0x416), sf::Uint32(0x1F600) }) {
+        event.type = Event::TextEntered;
+        event.text.unicode = c;
+        rv.push_back(event);
+    }
+
+    event.type = Event::LostFocus;
+    rv.push_back(event);
+
+    event.type = Event::Closed;
+    rv.push_back(event);
+    return rv;
+}
+
+bool events_equal(const Event & a, const Event & b) {
+    if (a.type != b.type) return false;
+    switch (a.type) {
+    case Event::Resized:
+        return a.size.width == b.size.width && a.size.height == b.size.height;
+    case Event::TextEntered:
+        return a.text.unicode == b.text.unicode;
+    case Event::KeyPressed: case Event::KeyReleased:
+        return    a.key.code == b.key.code && a.key.alt == b.key.alt
+               && a.key.control == b.key.control && a.key.shift == b.key.shift
+               && a.key.system == b.key.system;
+    case Event::MouseWheelScrolled:
+        return    a.mouseWheelScroll.wheel == b.mouseWheelScroll.wheel
+               && a.mouseWheelScroll.delta == b.mouseWheelScroll.delta
+               && a.mouseWheelScroll.x == b.mouseWheelScroll.x
+               && a.mouseWheelScroll.y == b.mouseWheelScroll.y;
+    case Event::MouseButtonPressed: case Event::MouseButtonReleased:
+        return    a.mouseButton.button == b.mouseButton.button
+               && a.mouseButton.x == b.mouseButton.x
+               && a.mouseButton.y == b.mouseButton.y;
+    case Event::MouseMoved:
+        return    a.mouseMove.x == b.mouseMove.x
+               && a.mouseMove.y == b.mouseMove.y;
+    default: return true; // no payload
+    }
+}
+
+} // end of <anonymous> namespace
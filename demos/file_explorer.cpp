@@ -34,89 +34,6 @@ struct FileInfo {
     std::string full_path;
 };
 
-template <typename WidgetType>
-class ScrollWidget final : public ksg::Widget {
-public:
-    static constexpr const float k_default_scroll_bar_size = 20.f;
-    using RenderTargetPtr = std::shared_ptr<sf::RenderTexture>;
-    static_assert(std::is_base_of_v<ksg::Widget, WidgetType>, "");
-
-    void process_event(const sf::Event &) override;
-
-    void set_location(float x, float y) override;
-
-    VectorF location() const override;
-
-    float width() const override;
-
-    float height() const override;
-
-    void set_style(const ksg::StyleMap &) override;
-
-    void set_window_size(float width_, float height_);
-
-private:
-    using HandledType = ksg::Widget;
-    void draw(sf::RenderTarget &, sf::RenderStates) const override;
-
-    void issue_auto_resize() override;
-
-    void iterate_children_(ksg::ChildWidgetIterator & itr) override { itr.on_child(m_widget); }
-    void iterate_const_children_(ksg::ChildWidgetIterator & itr) const override { itr.on_child(m_widget); }
-
-    DrawRectangle m_back;
-    DrawRectangle m_front;
-    WidgetType m_widget;
-    RenderTargetPtr m_target;
-};
-
-template <typename WidgetType>
-void ScrollWidget<WidgetType>::process_event(const sf::Event &) {
-
-}
-
-template <typename WidgetType>
-void ScrollWidget<WidgetType>::set_location(float x, float y) {
-
-}
-
-template <typename WidgetType>
-ksg::Widget::VectorF ScrollWidget<WidgetType>::location() const {
-
-}
-
-template <typename WidgetType>
-float ScrollWidget<WidgetType>::width() const {
-
-}
-
-template <typename WidgetType>
-float ScrollWidget<WidgetType>::height() const {
-
-}
-
-template <typename WidgetType>
-void ScrollWidget<WidgetType>::set_style(const ksg::StyleMap &) {
-
-}
-
-template <typename WidgetType>
-void ScrollWidget<WidgetType>::set_window_size(float width_, float height_) {
-
-}
-
-template <typename WidgetType>
-/* private */ void ScrollWidget<WidgetType>::draw(sf::RenderTarget &, sf::RenderStates) const {
-
-}
-
-template <typename WidgetType>
-/* private */ void ScrollWidget<WidgetType>::issue_auto_resize() {
-
-}
-
-using ScrollSelectionList = ScrollWidget<ksg::SelectionMenu>;
-
 class FileDisplayList final : public ksg::Frame {
 public:
     void setup();
@@ -133,6 +50,7 @@ private:
     ksg::TextButton m_up_button;
 
     ksg::SelectionMenu m_file_list_display;
+    std::vector<UString> m_file_names;
     std::vector<FileInfo> m_cwd_file_list;
 
     static bool * s_quit_flag;
@@ -211,7 +129,8 @@ void FileDisplayList::setup(SharedStylePtr styles_, const std::string & path) {
         return rhs.full_path < lhs.full_path;
     });
 
-    std::vector<ksg::Text::UString> files_strings;
+    auto & files_strings = m_file_names;
+    files_strings.clear();
     for (const auto & info : m_cwd_file_list) {
         auto pos = info.full_path.find_last_of('/');
         if (pos == std::string::npos) {
@@ -234,7 +153,12 @@ void FileDisplayList::setup(SharedStylePtr styles_, const std::string & path) {
     m_info_notice.set_text(U"File list " + to_ustring(std::to_string(m_cwd_file_list.size())));
     m_up_button.set_string(U"Up one level...");
     m_exit_button.set_string(U"Exit");
-    m_file_list_display.add_options(std::move(files_strings));
+    // only the visible names have entries, so huge directories are cheap
+    static constexpr const std::size_t k_visible_file_count = 16;
+    m_file_list_display.set_data_source(
+        [this]() { return m_file_names.size(); },
+        [this](std::size_t index) { return m_file_names[index]; },
+        k_visible_file_count);
 
     m_up_button.set_press_event([this, styles_]() {
         m_new_list = std::make_unique<FileDisplayList>();
@@ -0,0 +1,177 @@
+// Benchmarks drawing many small images, each on its own texture versus as
+// regions of an ImageAtlas, and loading one file into many image widgets
+// through the TextureCache.
+// Run from the demos directory, so that "images/apple.jpg" may be found.
+#include <ksg/Frame.hpp>
+#include <ksg/ImageWidget.hpp>
+#include <ksg/ImageAtlas.hpp>
+#include <ksg/TextureCache.hpp>
+#include <ksg/RenderStats.hpp>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+#include <cstdlib>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const int      k_image_count  = 256;
+constexpr const int      k_row_length   = 16;
+constexpr const unsigned k_icon_size    = 24;
+constexpr const int      k_frame_count  = 300;
+constexpr const int      k_widget_count = 100;
+constexpr const auto *   k_image_file   = "images/apple.jpg";
+
+class IconGrid final : public ksg::Frame {
+public:
+    using SetupFunc = std::function<void(ksg::ImageWidget &, int index)>;
+
+    void setup(int count, SetupFunc &&);
+
+    ksg::ImageWidget & icon(int index) { return m_icons[std::size_t(index)]; }
+
+private:
+    // a deque, so that widgets never move once added
+    std::deque<ksg::ImageWidget> m_icons;
+};
+
+struct DrawResult {
+    double ms_per_frame = 0.;
+    std::size_t draw_calls = 0;
+};
+
+DrawResult time_draws(IconGrid &);
+
+sf::Image make_icon(int index);
+
+double ms_since(Clock::time_point);
+
+void expect(bool, const char * description);
+
+} // end of <anonymous> namespace
+
+int main() {
+    std::vector<sf::Image> icons;
+    for (int i = 0; i != k_image_count; ++i) icons.push_back(make_icon(i));
+
+    IconGrid separate;
+    separate.setup(k_image_count, [&icons](ksg::ImageWidget & widget, int i) {
+        sf::Texture texture;
+        if (!texture.loadFromImage(icons[std::size_t(i)])) {
+            throw std::runtime_error("cannot upload icon");
+        }
+        widget.set_texture(std::move(texture));
+    });
+
+    ksg::ImageAtlas atlas;
+    IconGrid atlased;
+    atlased.setup(k_image_count, [&icons, &atlas](ksg::ImageWidget & widget, int i) {
+        widget.set_atlas_region(atlas.add_image(icons[std::size_t(i)]));
+    });
+
+    auto separate_result = time_draws(separate);
+    auto atlased_result  = time_draws(atlased);
+    std::cout << k_image_count << " images, " << k_frame_count << " frames each\n"
+              << "  separate textures: " << separate_result.draw_calls
+              << " draw calls, " << separate_result.ms_per_frame << "ms/frame\n"
+              << "  image atlas (" << atlas.page_count() << " page(s), "
+              << int(atlas.packing_efficiency()*100.) << "% packed): "
+              << atlased_result.draw_calls << " draw calls, "
+              << atlased_result.ms_per_frame << "ms/frame" << std::endl;
+    expect(atlased_result.draw_calls <= atlas.page_count() + 1,
+           "atlas regions are drawn together, one call per page");
+    expect(separate_result.draw_calls > atlased_result.draw_calls,
+           "separate textures take more draw calls");
+
+    // replacing an atlas region with a whole texture shows all of it, and
+    // nullptr shows nothing
+    sf::Texture whole;
+    if (!whole.loadFromImage(make_icon(0))) {
+        throw std::runtime_error("cannot upload icon");
+    }
+    atlased.icon(0).assign_texture(&whole);
+    atlased.icon(1).assign_texture(nullptr);
+    time_draws(atlased);
+
+    auto start = Clock::now();
+    std::deque<ksg::ImageWidget> widgets(k_widget_count);
+    expect(widgets.front().load_from_file(k_image_file), "image loads");
+    double first_ms = ms_since(start);
+    start = Clock::now();
+    for (auto & widget : widgets) widget.load_from_file(k_image_file);
+    double cached_ms = ms_since(start) / double(k_widget_count);
+    std::cout << "\"" << k_image_file << "\" in " << k_widget_count
+              << " widgets: first load " << first_ms << "ms, cached loads "
+              << cached_ms << "ms each, "
+              << ksg::TextureCache::instance().entry_count()
+              << " texture(s) cached" << std::endl;
+    expect(ksg::TextureCache::instance().entry_count() == 1,
+           "widgets showing the same file share one texture");
+    return 0;
+}
+
+namespace {
+
+void IconGrid::setup(int count, SetupFunc && setup_icon) {
+    m_icons.resize(std::size_t(count));
+    // the adder keeps the styles until it finishes
+    const auto styles_ = ksg::styles::construct_system_styles();
+    auto adder = begin_adding_widgets(styles_);
+    for (int i = 0; i != count; ++i) {
+        auto & icon = m_icons[std::size_t(i)];
+        setup_icon(icon, i);
+        icon.set_size(float(k_icon_size), float(k_icon_size));
+        adder.add(icon);
+        if ((i + 1) % k_row_length == 0) adder.add_line_seperator();
+    }
+}
+
+DrawResult time_draws(IconGrid & grid) {
+    sf::RenderTexture target;
+    if (!target.create(unsigned(grid.width()) + 1, unsigned(grid.height()) + 1)) {
+        throw std::runtime_error("time_draws: cannot create render target.");
+    }
+    ksg::RenderStats stats;
+    grid.set_render_stats(&stats);
+    auto start = Clock::now();
+    for (int i = 0; i != k_frame_count; ++i) {
+        target.clear();
+        target.draw(grid);
+        target.display();
+    }
+    DrawResult rv;
+    rv.ms_per_frame = ms_since(start) / double(k_frame_count);
+    rv.draw_calls = stats.totals().draw_calls;
+    grid.set_render_stats(nullptr);
+    return rv;
+}
+
+sf::Image make_icon(int index) {
+    sf::Image image;
+    const auto shade = sf::Uint8(index);
+    image.create(k_icon_size, k_icon_size, sf::Color(shade, 255 - shade, 128));
+    // a diagonal, so that each icon's orientation can be seen
+    for (unsigned i = 0; i != k_icon_size; ++i) {
+        image.setPixel(i, i, sf::Color::White);
+    }
+    return image;
+}
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void expect(bool passed, const char * description) {
+    if (passed) return;
+    std::cerr << "Image atlas benchmark check failed: " << description << std::endl;
+    std::exit(1);
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,188 @@
+// Checks that a frame's render cache is re-rendered exactly when something
+// in it changes. Frames are drawn off-screen, with RenderStats showing
+// whether the cache was re-rendered (many draw calls) or only blit (one).
+// Run from the demos directory, so that "font.ttf" may be found.
+#include <ksg/Frame.hpp>
+#include <ksg/TextArea.hpp>
+#include <ksg/TextButton.hpp>
+#include <ksg/ScrollView.hpp>
+#include <ksg/SelectionMenu.hpp>
+#include <ksg/RenderStats.hpp>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Window/Event.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+#include <cstdlib>
+
+namespace {
+
+using UString = ksg::Text::UString;
+using VectorF = ksg::Widget::VectorF;
+
+class NestedFrame final : public ksg::Frame {
+public:
+    void setup();
+    ksg::TextButton & button() { return m_button; }
+private:
+    ksg::TextButton m_button;
+};
+
+class CachedFrame final : public ksg::Frame {
+public:
+    void setup();
+    ksg::TextArea & notice() { return m_notice; }
+    ksg::TextButton & button() { return m_button; }
+    NestedFrame & nested() { return m_nested; }
+    ksg::ScrollView & menu_view() { return m_menu_view; }
+private:
+    ksg::TextArea m_notice;
+    ksg::TextButton m_button;
+    NestedFrame m_nested;
+    ksg::SelectionMenu m_menu;
+    ksg::ScrollView m_menu_view;
+};
+
+class Checker final {
+public:
+    explicit Checker(CachedFrame & frame);
+
+    // true if drawing the frame re-rendered its cache
+    bool draw_rerenders();
+
+    void move_mouse_to(const ksg::Widget &);
+
+    void move_mouse_to(float x, float y);
+
+private:
+    CachedFrame & m_frame;
+    sf::RenderTexture m_target;
+    ksg::RenderStats m_stats;
+};
+
+// assert is not used, as it would also remove the draws being checked
+void expect(bool, int line);
+
+#define expect_rerendered(checker) expect( (checker).draw_rerenders(), __LINE__)
+#define expect_cached(checker)     expect(!(checker).draw_rerenders(), __LINE__)
+
+} // end of <anonymous> namespace
+
+int main() {
+    CachedFrame frame;
+    frame.setup();
+    frame.enable_render_cache();
+    Checker checker(frame);
+
+    // the first draw always renders, later ones only if there are changes
+    expect_rerendered(checker);
+    expect_cached(checker);
+    expect_cached(checker);
+
+    // a widget change
+    frame.notice().set_string(U"Changed notice.");
+    expect_rerendered(checker);
+    expect_cached(checker);
+
+    // hovering changes a button, moving within it does not
+    checker.move_mouse_to(frame.button());
+    expect_rerendered(checker);
+    auto loc = frame.button().location();
+    checker.move_mouse_to(loc.x + 2.f, loc.y + 2.f);
+    expect_cached(checker);
+    checker.move_mouse_to(-10.f, -10.f);
+    expect_rerendered(checker);
+
+    // a change in a nested frame
+    frame.nested().button().set_string(U"Nested changed");
+    expect_rerendered(checker);
+    expect_cached(checker);
+
+    // changes to widgets inside a scroll view, which is not a frame
+    checker.move_mouse_to(frame.menu_view());
+    expect_rerendered(checker);
+    checker.move_mouse_to(-10.f, -10.f);
+    expect_rerendered(checker);
+    expect_cached(checker);
+
+    // changes to the frame itself
+    frame.set_title(U"New Title");
+    expect_rerendered(checker);
+    expect_cached(checker);
+
+    // without a cache, every draw renders
+    frame.disable_render_cache();
+    expect_rerendered(checker);
+    expect_rerendered(checker);
+
+    std::cout << "All render cache checks passed." << std::endl;
+    return 0;
+}
+
+namespace {
+
+void expect(bool passed, int line) {
+    if (passed) return;
+    std::cerr << "Render cache check on line " << line << " failed." << std::endl;
+    std::exit(1);
+}
+
+void NestedFrame::setup() {
+    m_button.set_string(U"Nested button");
+    begin_adding_widgets().add(m_button);
+}
+
+void CachedFrame::setup() {
+    auto styles_ = ksg::styles::construct_system_styles();
+    styles_[ksg::styles::k_global_font] = ksg::styles::load_font("font.ttf");
+
+    set_title(U"Render Cache Check");
+    m_notice.set_string(U"A notice.");
+    m_button.set_string(U"A button");
+    m_nested.setup();
+
+    std::vector<UString> options;
+    for (const auto * option : { U"One", U"Two", U"Three", U"Four", U"Five",
+                                 U"Six", U"Seven", U"Eight", U"Nine" })
+    { options.emplace_back(option); }
+    m_menu.add_options(std::move(options));
+    m_menu_view.set_child(m_menu);
+    m_menu_view.set_size(0.f, 60.f);
+
+    begin_adding_widgets(styles_)
+        .add(m_notice).add_line_seperator()
+        .add(m_button).add(m_nested).add_line_seperator()
+        .add(m_menu_view);
+}
+
+Checker::Checker(CachedFrame & frame): m_frame(frame) {
+    if (!m_target.create(unsigned(frame.width()) + 1,
+                         unsigned(frame.height()) + 1))
+    { throw std::runtime_error("Checker::Checker: cannot create target."); }
+    m_frame.set_render_stats(&m_stats);
+}
+
+bool Checker::draw_rerenders() {
+    m_target.clear();
+    m_target.draw(m_frame);
+    m_target.display();
+    // a cache which is only blit takes exactly one draw call
+    return m_stats.totals().draw_calls > 1;
+}
+
+void Checker::move_mouse_to(const ksg::Widget & widget) {
+    auto center = widget.location() + VectorF(widget.width(), widget.height())*0.5f;
+    move_mouse_to(center.x, center.y);
+}
+
+void Checker::move_mouse_to(float x, float y) {
+    sf::Event event;
+    event.type = sf::Event::MouseMoved;
+    event.mouseMove.x = int(x);
+    event.mouseMove.y = int(y);
+    m_frame.process_event(event);
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,132 @@
+// Draws frames of more and more widgets off-screen, and reports their draw
+// calls and vertices through RenderStats. Batching should keep the number
+// of draw calls the same, no matter how many widgets there are (or how many
+// of their texts are clipped).
+// Run from the demos directory, so that "font.ttf" may be found.
+#include <ksg/Frame.hpp>
+#include <ksg/TextArea.hpp>
+#include <ksg/TextButton.hpp>
+#include <ksg/ProgressBar.hpp>
+#include <ksg/RenderStats.hpp>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <deque>
+
+#include <cstdlib>
+
+namespace {
+
+using UString = ksg::Text::UString;
+
+// shapes take one call, and text of every size another (through the glyph
+// atlas), the rest is left as room to spare
+constexpr const int k_max_draw_calls = 4;
+
+class WidgetGrid final : public ksg::Frame {
+public:
+    void setup(const ksg::StyleMap &, int row_count);
+
+    const ksg::Widget & first_button() const { return m_buttons.front(); }
+
+private:
+    // a deque, so that widgets never move once added
+    std::deque<ksg::TextButton> m_buttons;
+    std::deque<ksg::TextArea> m_text_areas;
+    std::deque<ksg::ProgressBar> m_bars;
+};
+
+ksg::RenderStats draw_grid(const ksg::StyleMap &, int row_count);
+
+void expect(bool, const char * description);
+
+UString to_ustring(const std::string &);
+
+} // end of <anonymous> namespace
+
+int main() {
+    auto styles_ = ksg::styles::construct_system_styles();
+    styles_[ksg::styles::k_global_font] = ksg::styles::load_font("font.ttf");
+
+    std::size_t first_draw_calls = 0;
+    std::size_t last_vertices = 0;
+    for (int rows : { 1, 10, 100 }) {
+        auto stats = draw_grid(styles_, rows);
+        const auto & totals = stats.totals();
+        std::cout << rows*3 << " widgets: " << totals.draw_calls
+                  << " draw calls, " << totals.vertices << " vertices, "
+                  << totals.texture_switches << " texture switches, "
+                  << totals.unbatched_draws << " unbatched draws" << std::endl;
+
+        expect(totals.unbatched_draws == 0, "every widget here is batched");
+        expect(int(totals.draw_calls) <= k_max_draw_calls,
+               "draw calls are within budget");
+        if (first_draw_calls == 0) first_draw_calls = totals.draw_calls;
+        expect(totals.draw_calls == first_draw_calls,
+               "draw calls do not grow with the number of widgets");
+        expect(totals.vertices > last_vertices,
+               "vertices grow with the number of widgets");
+        last_vertices = totals.vertices;
+    }
+    std::cout << "All render stats checks passed." << std::endl;
+    return 0;
+}
+
+namespace {
+
+void WidgetGrid::setup(const ksg::StyleMap & styles_, int row_count) {
+    auto adder = begin_adding_widgets(styles_);
+    for (int i = 0; i != row_count; ++i) {
+        auto number = to_ustring(std::to_string(i + 1));
+        m_buttons.emplace_back();
+        m_buttons.back().set_string(U"Button " + number);
+        m_text_areas.emplace_back();
+        m_text_areas.back().set_string(U"Text area " + number);
+        m_text_areas.back().set_character_size(14);
+        // narrower than its text, so that every other label is clipped
+        if (i % 2) m_text_areas.back().set_width(40.f);
+        m_bars.emplace_back();
+        m_bars.back().set_size(100.f, 12.f);
+        m_bars.back().set_fill_amount(float(i % 10) / 10.f);
+        adder.add(m_buttons.back()).add(m_text_areas.back())
+             .add(m_bars.back()).add_line_seperator();
+    }
+}
+
+ksg::RenderStats draw_grid(const ksg::StyleMap & styles_, int row_count) {
+    WidgetGrid grid;
+    grid.setup(styles_, row_count);
+
+    sf::RenderTexture target;
+    if (!target.create(unsigned(grid.width()) + 1, unsigned(grid.height()) + 1)) {
+        throw std::runtime_error("draw_grid: cannot create render target.");
+    }
+    ksg::RenderStats stats;
+    grid.set_render_stats(&stats);
+    target.clear();
+    target.draw(grid);
+    target.display();
+
+    const auto * button_counts = stats.subtree_counts(grid.first_button());
+    expect(button_counts && button_counts->vertices > 0,
+           "widgets are counted as subtrees");
+    return stats;
+}
+
+void expect(bool passed, const char * description) {
+    if (passed) return;
+    std::cerr << "Render stats check failed: " << description << std::endl;
+    std::exit(1);
+}
+
+UString to_ustring(const std::string & str) {
+    UString rv;
+    rv.reserve(str.size());
+    for (char c : str) rv.push_back(UString::value_type(c));
+    return rv;
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,120 @@
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Window/Event.hpp>
+
+#include <ksg/Frame.hpp>
+#include <ksg/ScrollView.hpp>
+#include <ksg/SelectionMenu.hpp>
+#include <ksg/TextArea.hpp>
+#include <ksg/TextButton.hpp>
+
+#include <thread>
+
+// A long selection menu scrolled by a ScrollView, inside a frame which
+// (by default) draws from its render cache. Hovering and selecting entries
+// inside the view must still redraw the cached frame.
+
+namespace {
+
+using UString = ksg::Text::UString;
+
+constexpr const int   k_option_count = 300;
+constexpr const float k_view_height  = 300.f;
+
+class ScrollViewDemo final : public ksg::Frame {
+public:
+    void setup();
+    bool requesting_exit() const { return m_requesting_quit; }
+private:
+    void update_cache_toggle_string();
+
+    ksg::TextArea m_notice;
+    ksg::SelectionMenu m_menu;
+    ksg::ScrollView m_menu_view;
+    ksg::TextButton m_cache_toggle;
+    ksg::TextButton m_exit;
+    bool m_requesting_quit = false;
+};
+
+UString to_ustring(const std::string &);
+
+} // end of <anonymous> namespace
+
+int main() {
+    ScrollViewDemo frame;
+    frame.setup();
+
+    sf::RenderWindow win;
+    win.create(sf::VideoMode(unsigned(frame.width()), unsigned(frame.height())), " ");
+    while (win.isOpen()) {
+        sf::Event event;
+        while (win.pollEvent(event)) {
+            frame.process_event(event);
+            if (event.type == sf::Event::Closed || frame.requesting_exit()) {
+                win.close();
+            }
+        }
+        win.clear();
+        win.draw(frame);
+        win.display();
+        std::this_thread::sleep_for(std::chrono::microseconds(16667));
+    }
+}
+
+namespace {
+
+void ScrollViewDemo::setup() {
+    auto styles_ = ksg::styles::construct_system_styles();
+    styles_[ksg::styles::k_global_font] = ksg::styles::load_font("font.ttf");
+
+    set_title(U"Scroll View Test App");
+    set_drag_enabled(false);
+
+    m_notice.set_string(U"Scroll the list with the mouse wheel.");
+    m_notice.set_width(300.f);
+
+    std::vector<UString> options;
+    options.reserve(k_option_count);
+    for (int i = 1; i != k_option_count + 1; ++i) {
+        options.push_back(U"Option " + to_ustring(std::to_string(i)));
+    }
+    m_menu.add_options(std::move(options));
+    m_menu.set_response_function([this](std::size_t, const UString & option) {
+        m_notice.set_string(U"Selected: " + option);
+    });
+
+    // as wide as the menu, but only so tall
+    m_menu_view.set_child(m_menu);
+    m_menu_view.set_size(0.f, k_view_height);
+
+    enable_render_cache();
+    update_cache_toggle_string();
+    m_cache_toggle.set_press_event([this]() {
+        if (has_render_cache_enabled()) disable_render_cache();
+        else enable_render_cache();
+        update_cache_toggle_string();
+    });
+
+    m_exit.set_string(U"Exit");
+    m_exit.set_press_event([this]() { m_requesting_quit = true; });
+
+    begin_adding_widgets(styles_)
+        .add(m_notice).add_line_seperator()
+        .add(m_menu_view).add_line_seperator()
+        .add(m_cache_toggle).add_horizontal_spacer().add(m_exit);
+}
+
+void ScrollViewDemo::update_cache_toggle_string() {
+    m_cache_toggle.set_string(has_render_cache_enabled() ?
+        U"Render cache: on" : U"Render cache: off");
+}
+
+// ----------------------------------------------------------------------------
+
+UString to_ustring(const std::string & str) {
+    UString rv;
+    rv.reserve(str.size());
+    for (char c : str) rv.push_back(UString::value_type(c));
+    return rv;
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,157 @@
+// Draws the same line of text at several sizes, as regular glyphs and as
+// signed distance field glyphs, off-screen. Distance field glyphs are
+// rasterized only once, so drawing more sizes must not add any, and every
+// size must still draw together.
+// The result is saved to "sdf_text.png" for a look by eye.
+// Run from the demos directory, so that "font.ttf" may be found.
+#include <ksg/Text.hpp>
+#include <ksg/GlyphAtlas.hpp>
+#include <ksg/DrawBatch.hpp>
+#include <ksg/RenderStats.hpp>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using UString = ksg::Text::UString;
+
+constexpr const int    k_sizes[]         = { 12, 24, 48, 96 };
+constexpr const auto * k_sample          = U"Sharp at any size, 0123456789!";
+constexpr const auto * k_output_filename = "sdf_text.png";
+
+struct DrawResult {
+    std::size_t draw_calls = 0;
+    double ms = 0.;
+};
+
+// places a column of texts, one per size, starting at the given height
+std::deque<ksg::Text> make_texts
+    (const std::shared_ptr<const sf::Font> &, bool as_sdf, float top);
+
+DrawResult draw_texts(sf::RenderTarget &, const std::deque<ksg::Text> &);
+
+std::size_t count_distinct(const UString &);
+
+void expect(bool, const char * description);
+
+} // end of <anonymous> namespace
+
+int main() {
+    // a render target first, as glyphs (and the shader) need a context
+    sf::RenderTexture target;
+    if (!target.create(1600, 600)) {
+        throw std::runtime_error("cannot create render target.");
+    }
+    if (!ksg::GlyphAtlas::sdf_shader()) {
+        std::cout << "Shaders are not available, distance field glyphs cannot "
+                     "be drawn here; skipped." << std::endl;
+        return 0;
+    }
+    auto font = std::make_shared<sf::Font>();
+    if (!font->loadFromFile("font.ttf")) {
+        throw std::runtime_error("cannot load \"font.ttf\".");
+    }
+    const std::shared_ptr<const sf::Font> cfont = font;
+    auto & atlas = ksg::GlyphAtlas::instance();
+
+    // texts are laid out as they are made, which adds their glyphs
+    auto glyphs_before = atlas.glyph_count();
+    auto regular_texts = make_texts(cfont, false, 0.f);
+    const auto regular_glyphs = atlas.glyph_count() - glyphs_before;
+
+    glyphs_before = atlas.glyph_count();
+    auto sdf_texts = make_texts(cfont, true, regular_texts.back().location().y
+                                             + regular_texts.back().height());
+    const auto sdf_glyphs = atlas.glyph_count() - glyphs_before;
+    expect(sdf_texts.front().has_sdf_rendering_enabled(), "SDF is enabled");
+    // one for each distinct character, however many sizes there are
+    expect(sdf_glyphs <= count_distinct(k_sample),
+           "distance field glyphs are shared by every size");
+    expect(sdf_glyphs < regular_glyphs,
+           "regular glyphs are rasterized for each size");
+
+    target.clear();
+    auto regular = draw_texts(target, regular_texts);
+    glyphs_before = atlas.glyph_count();
+    auto sdf = draw_texts(target, sdf_texts);
+    target.display();
+    expect(atlas.glyph_count() == glyphs_before, "drawing adds no glyphs");
+
+    // metrics are scaled from one size, so widths follow character size
+    const auto expected_ratio = float(k_sizes[3]) / float(k_sizes[0]);
+    const auto ratio = sdf_texts.back().width() / sdf_texts.front().width();
+    expect(std::abs(ratio - expected_ratio) < expected_ratio*0.05f,
+           "widths scale with character size");
+    expect(sdf.draw_calls <= atlas.sdf_pages().page_count(),
+           "every size is drawn together");
+
+    std::cout << "regular glyphs: " << regular_glyphs << " rasterized, "
+              << regular.draw_calls << " draw call(s), " << regular.ms << "ms\n"
+              << "distance field glyphs: " << sdf_glyphs << " rasterized, "
+              << sdf.draw_calls << " draw call(s), " << sdf.ms << "ms" << std::endl;
+    if (target.getTexture().copyToImage().saveToFile(k_output_filename)) {
+        std::cout << "Saved to \"" << k_output_filename << "\"." << std::endl;
+    }
+    std::cout << "All distance field checks passed." << std::endl;
+    return 0;
+}
+
+namespace {
+
+std::deque<ksg::Text> make_texts
+    (const std::shared_ptr<const sf::Font> & font, bool as_sdf, float top)
+{
+    std::deque<ksg::Text> texts;
+    for (int size : k_sizes) {
+        texts.emplace_back();
+        auto & text = texts.back();
+        text.assign_font(font);
+        text.set_character_size(size);
+        if (as_sdf) text.enable_sdf_rendering();
+        text.set_string(UString(k_sample));
+        text.set_location(10.f, top);
+        top += text.height() + 4.f;
+    }
+    return texts;
+}
+
+DrawResult draw_texts(sf::RenderTarget & target, const std::deque<ksg::Text> & texts) {
+    DrawResult rv;
+    ksg::RenderStats stats;
+    auto start = Clock::now();
+    {
+    ksg::DrawBatch batch(target);
+    batch.set_render_stats(&stats);
+    for (const auto & text : texts) {
+        text.draw_to_batch(batch);
+    }
+    }
+    rv.ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    rv.draw_calls = stats.totals().draw_calls;
+    return rv;
+}
+
+std::size_t count_distinct(const UString & str) {
+    UString sorted = str;
+    std::sort(sorted.begin(), sorted.end());
+    return std::size_t(std::unique(sorted.begin(), sorted.end()) - sorted.begin());
+}
+
+void expect(bool passed, const char * description) {
+    if (passed) return;
+    std::cerr << "SDF text check failed: " << description << std::endl;
+    std::exit(1);
+}
+
+} // end of <anonymous> namespace
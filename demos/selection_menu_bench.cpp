@@ -0,0 +1,227 @@
+// Benchmarks keeping a selection menu of 10,000 options up to date, as a
+// few options change at a time: by rebuilding every option, by inserting,
+// erasing and replacing only the options that changed, and by refreshing a
+// data source (which only makes the visible entries).
+// Run from the demos directory, so that "font.ttf" may be found.
+#include <ksg/Frame.hpp>
+#include <ksg/SelectionMenu.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+using Clock   = std::chrono::steady_clock;
+using UString = ksg::Text::UString;
+
+constexpr const std::size_t k_option_count  = 10000;
+constexpr const int         k_update_count  = 50;
+constexpr const std::size_t k_visible_count = 20;
+
+// the menu is kept in a frame, so that its entries have a font, and so pay
+// for their text as they would in use
+class MenuFrame final : public ksg::Frame {
+public:
+    explicit MenuFrame(const ksg::StyleMap &);
+    ksg::SelectionMenu & menu() { return m_menu; }
+private:
+    ksg::SelectionMenu m_menu;
+};
+
+// one update: an option inserted, one erased and one replaced
+struct Update {
+    std::size_t insert_at, erase_at, replace_at;
+    UString inserted, replacement;
+};
+
+std::vector<UString> make_options();
+
+std::vector<Update> make_updates();
+
+void apply(std::vector<UString> &, const Update &);
+
+bool shows_options(ksg::SelectionMenu &, const std::vector<UString> &);
+
+// true if rows are stacked from the menu's top, each as tall as the first,
+// and the menu is as tall as all of them
+bool rows_are_placed(ksg::SelectionMenu &);
+
+double ms_since(Clock::time_point);
+
+void expect(bool, const char * description);
+
+UString to_ustring(const std::string &);
+
+} // end of <anonymous> namespace
+
+int main() {
+    auto styles_ = ksg::styles::construct_system_styles();
+    styles_[ksg::styles::k_global_font] = ksg::styles::load_font("font.ttf");
+    const auto updates = make_updates();
+
+    // rebuilding every option on each update
+    double rebuild_ms = 0.;
+    {
+    MenuFrame frame(styles_);
+    auto options = make_options();
+    frame.menu().add_options(std::vector<UString>(options));
+    auto start = Clock::now();
+    for (const auto & update : updates) {
+        apply(options, update);
+        frame.menu().add_options(std::vector<UString>(options));
+    }
+    rebuild_ms = ms_since(start) / double(k_update_count);
+    expect(shows_options(frame.menu(), options), "rebuilt menu is up to date");
+    expect(rows_are_placed(frame.menu()), "rebuilt menu's rows are placed");
+
+    // rebuilding with more, and then fewer options
+    options.resize(options.size() + 10, UString(U"Extra"));
+    frame.menu().add_options(std::vector<UString>(options));
+    expect(rows_are_placed(frame.menu()), "grown menu's rows are placed");
+    options.resize(options.size() / 2);
+    frame.menu().add_options(std::vector<UString>(options));
+    expect(rows_are_placed(frame.menu()), "shrunk menu's rows are placed");
+    expect(shows_options(frame.menu(), options), "shrunk menu is up to date");
+    }
+
+    // changing only what changed
+    double incremental_ms = 0.;
+    {
+    MenuFrame frame(styles_);
+    auto options = make_options();
+    frame.menu().add_options(std::vector<UString>(options));
+    auto start = Clock::now();
+    for (const auto & update : updates) {
+        apply(options, update);
+        auto & menu = frame.menu();
+        menu.insert_option(update.insert_at, UString(update.inserted));
+        menu.erase_option(update.erase_at);
+        menu.replace_option(update.replace_at, UString(update.replacement));
+    }
+    incremental_ms = ms_since(start) / double(k_update_count);
+    expect(shows_options(frame.menu(), options),
+           "incrementally updated menu is up to date");
+    }
+
+    // a data source, refreshed on each update
+    double data_source_ms = 0.;
+    {
+    MenuFrame frame(styles_);
+    auto options = make_options();
+    auto & menu = frame.menu();
+    menu.set_data_source([&options]() { return options.size(); },
+                         [&options](std::size_t i) { return options[i]; },
+                         k_visible_count);
+    auto start = Clock::now();
+    for (const auto & update : updates) {
+        apply(options, update);
+        menu.refresh_data_source();
+    }
+    data_source_ms = ms_since(start) / double(k_update_count);
+    expect(menu.option_count() == options.size(),
+           "data source menu has every option");
+    std::size_t entry_count = 0;
+    for (auto & entry : menu) {
+        expect(entry.string() == options[menu.first_visible_option() + entry_count],
+               "data source menu shows the first options");
+        ++entry_count;
+    }
+    expect(entry_count == k_visible_count,
+           "data source menu only makes the visible entries");
+    }
+
+    std::cout << k_option_count << " options, " << k_update_count
+              << " updates of three changes each\n"
+              << "  rebuilding        : " << rebuild_ms     << "ms per update\n"
+              << "  incremental       : " << incremental_ms << "ms per update\n"
+              << "  data source (" << k_visible_count << " visible): "
+              << data_source_ms << "ms per update" << std::endl;
+    expect(incremental_ms < rebuild_ms,
+           "incremental updates are faster than rebuilding");
+    return 0;
+}
+
+namespace {
+
+MenuFrame::MenuFrame(const ksg::StyleMap & styles_) {
+    begin_adding_widgets(styles_).add(m_menu);
+}
+
+std::vector<UString> make_options() {
+    std::vector<UString> options;
+    options.reserve(k_option_count);
+    for (std::size_t i = 0; i != k_option_count; ++i) {
+        options.push_back(U"Option " + to_ustring(std::to_string(i + 1)));
+    }
+    return options;
+}
+
+std::vector<Update> make_updates() {
+    std::vector<Update> updates;
+    // spread over the menu, a fixed seed keeps every run the same
+    std::srand(3);
+    for (int i = 0; i != k_update_count; ++i) {
+        Update update;
+        update.insert_at   = std::size_t(std::rand()) % k_option_count;
+        update.erase_at    = std::size_t(std::rand()) % k_option_count;
+        update.replace_at  = std::size_t(std::rand()) % k_option_count;
+        update.inserted    = U"Inserted " + to_ustring(std::to_string(i));
+        update.replacement = U"Replaced " + to_ustring(std::to_string(i));
+        updates.push_back(std::move(update));
+    }
+    return updates;
+}
+
+void apply(std::vector<UString> & options, const Update & update) {
+    options.insert(options.begin() + std::ptrdiff_t(update.insert_at), update.inserted);
+    options.erase(options.begin() + std::ptrdiff_t(update.erase_at));
+    options[update.replace_at] = update.replacement;
+}
+
+bool shows_options(ksg::SelectionMenu & menu, const std::vector<UString> & options) {
+    std::size_t i = 0;
+    for (auto & entry : menu) {
+        if (i == options.size() || entry.string() != options[i]) return false;
+        ++i;
+    }
+    return i == options.size();
+}
+
+bool rows_are_placed(ksg::SelectionMenu & menu) {
+    const ksg::Widget & menu_widget = menu;
+    if (menu.begin() == menu.end()) return menu_widget.height() == 0.f;
+    const float row_height = menu.begin()->height();
+    const auto top = menu_widget.location().y;
+    std::size_t i = 0;
+    for (const ksg::Widget & entry : menu) {
+        if (   std::abs(entry.location().y - (top + row_height*float(i))) > 0.5f
+            || std::abs(entry.height() - row_height) > 0.5f)
+        { return false; }
+        ++i;
+    }
+    return std::abs(menu_widget.height() - row_height*float(i)) < 0.5f;
+}
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void expect(bool passed, const char * description) {
+    if (passed) return;
+    std::cerr << "Selection menu benchmark check failed: " << description << std::endl;
+    std::exit(1);
+}
+
+UString to_ustring(const std::string & str) {
+    UString rv;
+    rv.reserve(str.size());
+    for (char c : str) rv.push_back(UString::value_type(c));
+    return rv;
+}
+
+} // end of <anonymous> namespace
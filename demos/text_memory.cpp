@@ -0,0 +1,93 @@
+// Reports how much memory a text keeps per character, as compact glyph
+// records against the drawable characters (four vertices each) texts used
+// to keep. The text sampled is 10,000 characters of ordinary prose.
+// Needs no window or font, the sizes are those of this platform's types.
+#include <ksg/DrawCharacter.hpp>
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <cstdlib>
+
+namespace {
+
+constexpr const std::size_t k_text_length = 10000;
+constexpr const auto * k_sample =
+    "The quick brown fox jumps over the lazy dog, 0123456789 times. "
+    "Pack my box with five dozen liquor jugs! ";
+
+// the layout of the character texts kept before glyph records, one per
+// character: a drawable holding its quad and its page texture
+class OldDrawableCharacter final : public sf::Drawable {
+    void draw(sf::RenderTarget &, sf::RenderStates) const override {}
+    sf::Vertex m_vertices[4];
+    const sf::Texture * m_texture = nullptr;
+};
+
+std::string make_text();
+
+std::size_t count_distinct(std::string);
+
+void expect(bool, const char * description);
+
+} // end of <anonymous> namespace
+
+int main() {
+    using namespace ksg::detail;
+    const auto text = make_text();
+    // spaces are dropped by layout, so have no record nor quad
+    const auto glyph_count = std::size_t(std::count_if(
+        text.begin(), text.end(), [](char c) { return c != ' '; }));
+    const auto distinct_glyphs = count_distinct(text) - 1;
+
+    const auto old_bytes = glyph_count*sizeof(OldDrawableCharacter);
+    // one color, the text's own
+    const auto new_bytes = glyph_count*sizeof(GlyphRecord)
+                           + distinct_glyphs*sizeof(GlyphQuad)
+                           + sizeof(sf::Color);
+    const auto per_char = [&text](std::size_t bytes)
+        { return double(bytes) / double(text.size()); };
+
+    std::cout << text.size() << " characters, " << glyph_count << " glyphs, "
+              << distinct_glyphs << " distinct\n"
+              << "  drawable character: " << sizeof(OldDrawableCharacter)
+              << " bytes each\n"
+              << "  glyph record      : " << sizeof(GlyphRecord)
+              << " bytes each, plus " << sizeof(GlyphQuad)
+              << " per distinct glyph\n"
+              << "  before: " << old_bytes << " bytes, "
+              << per_char(old_bytes) << " per character\n"
+              << "  after : " << new_bytes << " bytes, "
+              << per_char(new_bytes) << " per character" << std::endl;
+    expect(new_bytes*4 < old_bytes, "records take under a quarter of the memory");
+    return 0;
+}
+
+namespace {
+
+std::string make_text() {
+    const std::string sample = k_sample;
+    std::string rv;
+    rv.reserve(k_text_length);
+    while (rv.size() != k_text_length) {
+        rv.append(sample, 0, std::min(sample.size(), k_text_length - rv.size()));
+    }
+    return rv;
+}
+
+std::size_t count_distinct(std::string str) {
+    std::sort(str.begin(), str.end());
+    return std::size_t(std::unique(str.begin(), str.end()) - str.begin());
+}
+
+void expect(bool passed, const char * description) {
+    if (passed) return;
+    std::cerr << "Text memory check failed: " << description << std::endl;
+    std::exit(1);
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,101 @@
+/****************************************************************************
+
+    File: AcceleratorTable.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Window/Keyboard.hpp>
+
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+namespace sf { class Event; }
+
+namespace ksg {
+
+/** @brief Maps key combinations (key + modifiers) to callbacks, for keyboard
+ *         shortcuts.
+ *
+ *  Lookups are done through a flat, open addressed hash table. So the cost of
+ *  a key press is constant no matter how many shortcuts are registered.
+ *  @see Frame::add_accelerator
+ */
+class AcceleratorTable final {
+public:
+    using Callback = std::function<void()>;
+    using Key      = sf::Keyboard::Key;
+
+    //! modifiers may be combined with bitwise or
+    enum Modifier : std::uint8_t {
+        k_no_modifiers = 0,
+        k_alt          = 1 << 0,
+        k_control      = 1 << 1,
+        k_shift        = 1 << 2,
+        k_system       = 1 << 3
+    };
+
+    /** Adds (or replaces) the callback for a key combination.
+     *  @param modifiers modifier keys which must be held, and no others
+     *  @throws if the key is unknown, or the callback is empty
+     */
+    void insert(Key, std::uint8_t modifiers, Callback &&);
+
+    /** @returns true if an accelerator was found and removed */
+    bool erase(Key, std::uint8_t modifiers);
+
+    void clear();
+
+    /** Calls the callback matching a key press event, if there is one.
+     *  @note The callback may safely insert or erase accelerators (including
+     *        its own).
+     *  @returns true if the event was handled by an accelerator
+     */
+    bool process_event(const sf::Event &) const;
+
+    std::size_t size() const noexcept { return m_size; }
+
+    bool is_empty() const noexcept { return m_size == 0; }
+
+    void swap(AcceleratorTable &);
+
+private:
+    static constexpr const std::uint32_t k_empty_slot = 0;
+
+    struct Entry {
+        //! k_empty_slot if unused, see to_packed_combo
+        std::uint32_t combo = k_empty_slot;
+        Callback callback;
+    };
+
+    // key must not be unknown
+    static std::uint32_t to_packed_combo(Key, std::uint8_t modifiers) noexcept;
+
+    std::size_t home_slot_of(std::uint32_t combo) const noexcept;
+
+    std::size_t find_slot(std::uint32_t combo) const noexcept;
+
+    void grow();
+
+    std::vector<Entry> m_entries;
+    std::size_t m_size = 0;
+};
+
+} // end of ksg namespace
@@ -41,12 +41,14 @@ public:
     void set_direction(Direction dir_);
 
     void set_arrow_color(sf::Color color_)
-        { m_draw_tri.set_color(color_); }
+        { m_draw_tri.set_color(color_); request_redraw(); }
 
     Direction direction() const { return m_dir; }
 
     void process_event(const sf::Event & evnt) override;
 
+    void draw_to_batch(DrawBatch &) const override;
+
 private:
     void draw(sf::RenderTarget & target, sf::RenderStates) const override;
 
@@ -0,0 +1,143 @@
+/****************************************************************************
+
+    File: BitmapFont.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/Glyph.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <cstdint>
+
+namespace ksg {
+
+/** @brief A pre-baked font, made of textures and a BMFont metrics file
+ *         (text format, as written by AngelCode's BMFont and most tools
+ *         which imitate it).
+ *
+ *  Nothing is rasterized at run time and FreeType is never loaded, so
+ *  loading is fast, and metrics are the same everywhere. Glyphs are drawn
+ *  at the size they were baked at, and scaled for any other character size.
+ *
+ *  Bitmap fonts may be used wherever a style accepts a font.
+ *  @see styles::load_bitmap_font
+ */
+class BitmapFont final {
+public:
+    struct CharacterRecord {
+        char32_t code_point = 0;
+        //! page which the texture rectangle is on
+        std::size_t page = 0;
+        //! at the baked size, bounds' top is relative to the baseline
+        sf::Glyph glyph;
+    };
+
+    BitmapFont() {}
+
+    BitmapFont(const BitmapFont &) = delete;
+
+    BitmapFont & operator = (const BitmapFont &) = delete;
+
+    /** Loads the metrics file and every page texture it names, page file
+     *  names are relative to the metrics file's directory.
+     *  @returns false if either cannot be loaded, in which case this font
+     *           is unchanged
+     */
+    bool load_from_file(const std::string & filename);
+
+    /** Loads only metrics, no textures, this is useful for measuring text
+     *  where nothing is drawn (e.g. tests).
+     *  @returns false if the metrics are malformed
+     */
+    bool load_metrics(std::istream &);
+
+    /** @returns the glyph for a code point, or if there is none, that for
+     *           '?' (or failing that, an empty glyph)
+     */
+    const CharacterRecord & glyph(char32_t) const;
+
+    bool has_glyph(char32_t) const;
+
+    /** @returns kerning (at the baked size) between two code points */
+    float kerning(char32_t first, char32_t second) const;
+
+    bool has_kerning() const noexcept { return !m_kernings.empty(); }
+
+    /** @returns the advance (at the baked size) shared by every printable
+     *           ASCII glyph, with no kerning between any of them, or zero
+     *           if there is no such advance
+     */
+    float fixed_advance() const noexcept { return m_fixed_advance; }
+
+    //! character size the glyphs were baked at
+    unsigned baked_size() const noexcept { return m_baked_size; }
+
+    //! line spacing at the baked size
+    float line_spacing() const noexcept { return m_line_spacing; }
+
+    //! distance from the top of a line to the baseline, at the baked size
+    float baseline() const noexcept { return m_baseline; }
+
+    std::size_t page_count() const noexcept { return m_pages.size(); }
+
+    /** @returns a page's texture, or nullptr if only metrics were loaded */
+    const sf::Texture * page_texture(std::size_t page) const;
+
+    std::size_t glyph_count() const noexcept { return m_glyphs.size(); }
+
+private:
+    // first in the upper half, second in the lower
+    using KerningKey = std::uint64_t;
+
+    struct Kerning {
+        KerningKey key = 0;
+        float amount = 0.f;
+    };
+
+    void swap(BitmapFont &) noexcept;
+
+    // returns nullptr if there is no glyph for the code point
+    const CharacterRecord * find_glyph(char32_t) const;
+
+    // zero unless all glyphs present of the fixed advance sample share an
+    // advance, and no kerning pair lies entirely within the sample
+    float find_fixed_advance() const;
+
+    static KerningKey make_kerning_key(char32_t first, char32_t second) noexcept
+        { return (KerningKey(first) << 32) | KerningKey(second); }
+
+    // sorted by code point, for binary searching
+    std::vector<CharacterRecord> m_glyphs;
+    // sorted by key
+    std::vector<Kerning> m_kernings;
+    // file names as given by the metrics, indexed by page id
+    std::vector<std::string> m_page_files;
+    std::vector<std::unique_ptr<sf::Texture>> m_pages;
+    unsigned m_baked_size = 0;
+    float m_line_spacing = 0.f;
+    float m_baseline = 0.f;
+    float m_fixed_advance = 0.f;
+};
+
+} // end of ksg namespace
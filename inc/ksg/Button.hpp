@@ -98,6 +98,11 @@ public:
      */
     void set_style(const StyleMap &) override;
 
+    /** Adds the button's background to the batch. Override to add your own
+     *  button markings (see Button::draw).
+     */
+    void draw_to_batch(DrawBatch &) const override;
+
     /** Padding, which is applied both horizontally and vertically. Maybe
      *  useful with geometry updates.
      *  @note added to public interface, some composite widgets may need to
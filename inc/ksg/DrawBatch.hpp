@@ -0,0 +1,211 @@
+/****************************************************************************
+
+    File: DrawBatch.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+
+namespace sf { class RenderTarget; class Drawable; class Texture; class Shader; }
+
+class DrawRectangle;
+class DrawTriangle;
+
+namespace ksg {
+
+class RenderStats;
+
+/** @brief Collects the geometry of many simple drawables so that it may be
+ *         drawn with as few draw calls as possible.
+ *
+ *  Geometry is kept as triangles in "buckets", one per texture and shader
+ *  (untextured geometry sharing a bucket of its own). On flushing, each
+ *  bucket is drawn with a single call, in the order that each was first
+ *  seen.
+ *
+ *  Geometry within the same bucket keeps its order. Across buckets however,
+ *  later geometry may end up underneath (for instance a rectangle added after
+ *  some text, will be drawn before that text). Anything which must be on top
+ *  of what came before should be added following a flush.
+ *
+ *  Drawing may be clipped to a stack of rectangles. Clipping is done by
+ *  changing the target's view (and its viewport), so it costs nothing per
+ *  vertex, though each push and pop flushes. Likewise, a stack of
+ *  transforms may be applied to what follows (e.g. to scroll contents
+ *  without moving them).
+ *  @note Anything drawn straight to the target, should instead go through
+ *        draw_unbatched, so that it is ordered correctly.
+ */
+class DrawBatch final {
+public:
+    using VectorF = sf::Vector2f;
+
+    /** @param states used for every draw, except that the texture is always
+     *         replaced by a bucket's texture
+     */
+    explicit DrawBatch(sf::RenderTarget &,
+                       const sf::RenderStates & = sf::RenderStates::Default);
+
+    DrawBatch(const DrawBatch &) = delete;
+
+    /** Flushes anything remaining, and restores the target's view if any
+     *  clip is still pushed.
+     */
+    ~DrawBatch();
+
+    DrawBatch & operator = (const DrawBatch &) = delete;
+
+    void add_rectangle(const DrawRectangle &);
+
+    void add_triangle(const DrawTriangle &);
+
+    /** Adds a quad, given in the same order used by sf::Quads.
+     *  @param texture may be nullptr for untextured quads
+     *  @param shader if nullptr, the batch's states' shader is used
+     */
+    void add_quad(const sf::Vertex * quad, const sf::Texture * texture,
+                  const sf::Shader * shader = nullptr);
+
+    /** Adds a list of triangles.
+     *  @param count number of vertices, must be a multiple of three
+     *  @param texture may be nullptr for untextured triangles
+     *  @param shader if nullptr, the batch's states' shader is used
+     */
+    void add_triangles(const sf::Vertex * vertices, std::size_t count,
+                       const sf::Texture * texture,
+                       const sf::Shader * shader = nullptr);
+
+    /** Flushes, and then draws the drawable straight to the target. */
+    void draw_unbatched(const sf::Drawable &);
+
+    /** Draws all collected geometry, emptying this batch. */
+    void flush();
+
+    /** @brief Flushes, then has everything that follows drawn only inside
+     *         the given area, and inside any area pushed before it.
+     *
+     *  The area is snapped to whole pixels of the target.
+     *  @param area in the same coordinates as added geometry (that is before
+     *         this batch's transform)
+     */
+    void push_clip(const sf::FloatRect & area);
+
+    /** Flushes, then restores the clip from before the last push. */
+    void pop_clip();
+
+    std::size_t clip_depth() const noexcept { return m_clips.size(); }
+
+    /** Flushes, then has everything that follows transformed by the given
+     *  transform, after any pushed before it.
+     */
+    void push_transform(const sf::Transform &);
+
+    /** Flushes, then restores the transform from before the last push. */
+    void pop_transform();
+
+    /** @returns the area of the target's present view (and so inside of any
+     *           clip), in the same coordinates as added geometry, which is
+     *           useful for culling
+     */
+    sf::FloatRect visible_area() const;
+
+    /** @returns true if the current clip leaves nothing visible, in which
+     *           case additions are ignored
+     */
+    bool is_clipped_out() const noexcept { return m_clipped_out; }
+
+    sf::RenderTarget & target() const noexcept { return *m_target; }
+
+    const sf::RenderStates & states() const noexcept { return m_states; }
+
+    /** Has all draws (and additions) counted, stats may be nullptr to stop
+     *  counting. (default)
+     */
+    void set_render_stats(RenderStats * stats) noexcept
+        { m_render_stats = stats; }
+
+    RenderStats * render_stats() const noexcept { return m_render_stats; }
+
+private:
+    struct Bucket {
+        const sf::Texture * texture = nullptr;
+        const sf::Shader * shader = nullptr;
+        std::vector<sf::Vertex> vertices;
+    };
+
+    // what to restore on popping a clip
+    struct Clip {
+        sf::View previous_view;
+        bool previously_clipped_out = false;
+    };
+
+    std::vector<sf::Vertex> & bucket_for(const sf::Texture *, const sf::Shader *);
+
+    sf::RenderTarget * m_target;
+    sf::RenderStates m_states;
+    RenderStats * m_render_stats = nullptr;
+    // buckets are not removed on flushes, so their memory may be reused
+    std::vector<Bucket> m_buckets;
+    std::vector<Clip> m_clips;
+    // transforms to restore on popping
+    std::vector<sf::Transform> m_transforms;
+    bool m_clipped_out = false;
+};
+
+/** Pushes a clip for its lifetime. */
+class ScopedClip final {
+public:
+    ScopedClip(DrawBatch & batch, const sf::FloatRect & area):
+        m_batch(batch)
+    { m_batch.push_clip(area); }
+
+    ScopedClip(const ScopedClip &) = delete;
+
+    ScopedClip & operator = (const ScopedClip &) = delete;
+
+    ~ScopedClip() { m_batch.pop_clip(); }
+
+private:
+    DrawBatch & m_batch;
+};
+
+/** Pushes a transform for its lifetime. */
+class ScopedTransform final {
+public:
+    ScopedTransform(DrawBatch & batch, const sf::Transform & transform):
+        m_batch(batch)
+    { m_batch.push_transform(transform); }
+
+    ScopedTransform(const ScopedTransform &) = delete;
+
+    ScopedTransform & operator = (const ScopedTransform &) = delete;
+
+    ~ScopedTransform() { m_batch.pop_transform(); }
+
+private:
+    DrawBatch & m_batch;
+};
+
+} // end of ksg namespace
@@ -21,78 +21,65 @@
 
 #pragma once
 
-#include <SFML/Graphics/Drawable.hpp>
-#include <SFML/Graphics/Glyph.hpp>
 #include <SFML/Graphics/Color.hpp>
-#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Shader.hpp>
 
-#include <common/FixedLengthArray.hpp>
+#include <limits>
+#include <cstdint>
 
 namespace ksg {
 
-namespace detail {
-
-/** @brief Contains common features to both draw character and the version
- *         without advance (positional stepping) information.
- *  This class represents a single drawable character and can be treated
- *  similarly to a sprite. What makes this class notable is that it is able to
- *  partially truncate the character by "cutting" it. Methods that accomplish
- *  this are "cut_on_right" and "cut_on_bottom". Further cutting methods maybe
- *  added in the future.
- *  @warning Once a character has been cut it cannot be restored short of
- *           re-initializing the character from its original glyph.
- */
-class DrawableCharacter : public sf::Drawable {
-public:
-    using VectorF = sf::Vector2f;
-
-    DrawableCharacter() {}
-
-    DrawableCharacter(VectorF loc, const sf::Glyph & glyph, sf::Color clr);
-
-    DrawableCharacter(const sf::Glyph & glyph, sf::Color clr);
-
-    void set_color(sf::Color clr);
-
-    sf::Color color() const;
-
-    float width() const;
-
-    float height() const;
+class DrawBatch;
 
-    /** Cuts off part of a quad by changing its right verticies. A cut is made
-     *  by changing positions and the texture rectangle's coordinates to give a
-     *  "cut-off" effect. This will cause the right side of the character to
-     *  be omitted from rendering.
-     *  @param cut_line X-coordinate where the cut is made.
-     */
-    void cut_on_right(float cut_line);
-
-    /** Cuts off part of a quad by changing its bottom verticies. A cut is made
-     *  by changing positions and the texture rectangle's coordinates to give a
-     *  "cut-off" effect. This will cause the bottom of the character to be
-     *  omitted from rendering.
-     *  @param cut_line Y-coordinate where the cut is made.
-     */
-    void cut_on_bottom(float cut_line);
-
-    void set_location(float x, float y);
-
-    VectorF location() const;
-
-    void move(float x, float y);
+namespace detail {
 
-    bool whiped_out() const;
+/** Geometry shared by every character of a text showing the same glyph. */
+struct GlyphQuad {
+    sf::Vector2f size;
+    sf::FloatRect texture_rectangle;
+    const sf::Texture * texture = nullptr;
+};
 
-private:
-    void draw(sf::RenderTarget & target, sf::RenderStates states) const final;
+/** @brief A single character as placed by layout, which is expanded into
+ *         vertices only when drawn.
+ *
+ *  Characters refer to their layout's table of quads by index, which keeps
+ *  each to twelve bytes (with padding), rather than the eighty bytes of the
+ *  four vertices needed to draw it. Colors are kept by the text, so that
+ *  layouts may be shared.
+ */
+struct GlyphRecord {
+    using IndexType = std::uint16_t;
 
-    void check_invarients() const;
+    static constexpr const std::size_t k_max_table_size =
+        std::size_t(std::numeric_limits<IndexType>::max()) + 1;
 
-    FixedLengthArray<sf::Vertex, 4> m_verticies;
+    //! top left of the quad, relative to the text's location
+    sf::Vector2f location;
+    IndexType quad = 0;
 };
 
+/** Adds a character's quad to a batch.
+ *  @param offset added to the character's location
+ *  @param shader drawn with, if not nullptr
+ */
+void add_glyph_to_batch(DrawBatch &, const GlyphRecord &, const GlyphQuad &,
+                        sf::Color, sf::Vector2f offset, const sf::Shader * shader);
+
+/** Adds only the part of a character's quad inside a clipping area, with
+ *  its texture coordinates trimmed to match. Unlike clipping with the
+ *  batch, this never flushes it.
+ *  @param clip_area relative to the character's location, before offset
+ *  @param offset added to the character's location
+ *  @param shader drawn with, if not nullptr
+ */
+void add_clipped_glyph_to_batch
+    (DrawBatch &, const GlyphRecord &, const GlyphQuad &, sf::Color,
+     const sf::FloatRect & clip_area, sf::Vector2f offset,
+     const sf::Shader * shader);
+
 } // end of detail namespace
 
 } // end of ksg namespace
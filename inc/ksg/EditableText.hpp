@@ -38,6 +38,7 @@ public:
     void set_size(float w, float h);
     void set_location(float x, float y);
     float width() const { return m_back.width(); }
+    void draw_to_batch(DrawBatch &) const;
 private:
 
     static constexpr const int   k_dot_shape_count = 6;
@@ -122,6 +123,8 @@ public:
 
     void set_text_change_event(BlankFunc &&);
 
+    void draw_to_batch(DrawBatch &) const override;
+
 private:
     float max_text_width() const;
 
@@ -0,0 +1,110 @@
+/****************************************************************************
+
+    File: EventQueue.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Window/Event.hpp>
+
+#include <vector>
+#include <atomic>
+
+namespace ksg {
+
+class Widget;
+
+/** @brief A bounded, single producer/single consumer queue of events.
+ *
+ *  This allows input to be polled on one thread (the producer), while a
+ *  widget tree is fed on another (the consumer, normally the render thread).
+ *  Neither pushing nor popping will lock or allocate, all storage is reserved
+ *  on construction.
+ *
+ *  @code
+// input thread
+sf::Event event;
+while (window.waitEvent(event)) { queue.push(event); }
+
+// render thread
+queue.drain_into(root_frame);
+    @endcode
+ *  @note Exactly one thread may push, and exactly one (other) thread may
+ *        pop/drain. No other arrangement is safe.
+ */
+class EventQueue final {
+public:
+    static constexpr const std::size_t k_default_capacity = 1024;
+
+    /** @param capacity minimum number of events the queue may hold, this is
+     *         rounded up to the next power of two
+     */
+    explicit EventQueue(std::size_t capacity = k_default_capacity);
+
+    EventQueue(const EventQueue &) = delete;
+
+    EventQueue & operator = (const EventQueue &) = delete;
+
+    /** @brief (producer only) Adds an event to the back of the queue.
+     *  @returns false if the queue is full, in which case the event is dropped
+     */
+    bool push(const sf::Event &) noexcept;
+
+    /** @brief (consumer only) Removes an event from the front of the queue.
+     *  @returns false if the queue is empty, leaving the given event untouched
+     */
+    bool pop(sf::Event &) noexcept;
+
+    /** @brief (consumer only) Sends queued events to a widget, usually the
+     *         root frame.
+     *
+     *  Only those events present at the time of the call are processed, so a
+     *  producer that never stops pushing cannot stall the consumer here.
+     *  @returns the number of events sent to the widget
+     */
+    std::size_t drain_into(Widget &);
+
+    std::size_t capacity() const noexcept { return m_events.size(); }
+
+    /** @note The returned value is only a snapshot, the other thread may
+     *        change the size at any time.
+     */
+    std::size_t size() const noexcept;
+
+    bool is_empty() const noexcept { return size() == 0; }
+
+private:
+    // positions always increase, and are only ever masked for indexing
+    static constexpr const std::size_t k_cache_line_size = 64;
+
+    static std::size_t round_up_to_power_of_two(std::size_t);
+
+    std::vector<sf::Event> m_events;
+    std::size_t m_mask = 0;
+
+    // producer owned line
+    alignas(k_cache_line_size) std::atomic<std::size_t> m_write_pos { 0 };
+    std::size_t m_cached_read_pos = 0;
+
+    // consumer owned line
+    alignas(k_cache_line_size) std::atomic<std::size_t> m_read_pos { 0 };
+    std::size_t m_cached_write_pos = 0;
+};
+
+} // end of ksg namespace
@@ -0,0 +1,122 @@
+/****************************************************************************
+
+    File: EventRecorder.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Window/Event.hpp>
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <fstream>
+
+namespace ksg {
+
+class Widget;
+
+/** @brief Records every event sent to a root widget, along with the time it
+ *         arrived, into a compact binary file.
+ *
+ *  Use in place of the root widget's process_event, all events are passed on
+ *  unchanged. Recordings can then be replayed with EventPlayer, reproducing
+ *  the exact same event stream against the same widget tree.
+ *  @code
+ksg::EventRecorder recorder(dialog, "session.ksgevents");
+while (window.pollEvent(event)) {
+    recorder.process_event(event);
+}
+    @endcode
+ */
+class EventRecorder final {
+public:
+    /** @throws if the file cannot be opened for writing */
+    EventRecorder(Widget & root, const std::string & filename);
+
+    EventRecorder(const EventRecorder &) = delete;
+
+    EventRecorder & operator = (const EventRecorder &) = delete;
+
+    /** Writes the event (with a time stamp) and then sends it to the root
+     *  widget.
+     */
+    void process_event(const sf::Event &);
+
+    /** Forces everything recorded so far to be written to file. */
+    void flush();
+
+    std::size_t recorded_count() const noexcept { return m_count; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Widget * m_root;
+    std::ofstream m_out;
+    Clock::time_point m_start;
+    std::chrono::microseconds m_last_time { 0 };
+    std::size_t m_count = 0;
+};
+
+/** @brief Plays back an event recording made by EventRecorder into a widget
+ *         tree, timing how long each event takes to be processed.
+ */
+class EventPlayer final {
+public:
+    using Nanoseconds  = std::chrono::nanoseconds;
+    using Microseconds = std::chrono::microseconds;
+
+    enum class Pacing {
+        //! send events back to back, ignoring recorded times
+        k_as_fast_as_possible,
+        //! wait between events, as they occured when recorded
+        k_real_time
+    };
+
+    struct RecordedEvent {
+        //! time since the recording started
+        Microseconds time { 0 };
+        sf::Event event;
+    };
+
+    struct DispatchTime {
+        Microseconds recorded_time { 0 };
+        sf::Event::EventType type = sf::Event::Count;
+        //! time the widget tree took to process this event
+        Nanoseconds dispatch_time { 0 };
+    };
+
+    /** @returns false if the file could not be opened, or is not a valid
+     *           recording; in which case the player holds no events
+     */
+    bool load_from_file(const std::string & filename);
+
+    /** Sends all loaded events to the given widget, in the order recorded.
+     *  @returns per event dispatch times, one for each loaded event
+     */
+    std::vector<DispatchTime> replay(Widget &, Pacing = Pacing::k_as_fast_as_possible) const;
+
+    const std::vector<RecordedEvent> & events() const noexcept
+        { return m_events; }
+
+private:
+    std::vector<RecordedEvent> m_events;
+};
+
+} // end of ksg namespace
@@ -116,6 +116,7 @@ public:
 
     /** @brief Checks for events that trigger a focus advance. This also sends
      *         focus events to the current focus widget.
+     *  @note hidden widgets are passed over as focus advances (or regresses)
      */
     void process_event(const sf::Event &);
 
@@ -142,6 +143,11 @@ public:
     static bool default_focus_regress(const sf::Event &);
 
 private:
+    // move to the next (or previous) visible widget, wrapping around
+    void advance_to_visible();
+
+    void regress_to_visible();
+
     FocusChangeFunc m_advance_func = default_focus_advance;
     FocusChangeFunc m_regress_func = default_focus_regress;
 
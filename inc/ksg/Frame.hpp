@@ -23,8 +23,13 @@
 
 #include <ksg/FrameBorder.hpp>
 #include <ksg/FocusWidget.hpp>
+#include <ksg/AcceleratorTable.hpp>
+#include <ksg/RenderStats.hpp>
+
+#include <SFML/Graphics/RenderTexture.hpp>
 
 #include <vector>
+#include <memory>
 
 namespace ksg {
 
@@ -179,8 +184,10 @@ public:
 
     /** Processes an event. If the frame is draggable and has a title it can
      *  move with the user's mouse cursor. This function also sends events to
-     *  all its widgets.
+     *  all its visible widgets, except those entirely outside of the event
+     *  clip (if one is set).
      *  @param evnt
+     *  @see Frame::set_event_clip
      */
     void process_event(const sf::Event &) override;
 
@@ -195,6 +202,11 @@ public:
 
     void automatically_set_size() { set_size(0.f, 0.f); }
 
+    /** Adds the frame's border and all of its widgets to the batch, frames
+     *  contained in this one share the same batch.
+     */
+    void draw_to_batch(DrawBatch &) const override;
+
     /** Sets the size of the containing frame. This also happens to be the
      *  frame's border (and title) also.
      *  @param w width in pixels
@@ -251,6 +263,92 @@ public:
 
     void set_padding(float pixels);
 
+    /** @brief Restricts mouse events to widgets which are at least partly
+     *         inside the given area.
+     *
+     *  Widgets that lie entirely outside the area will not receive mouse
+     *  moves, clicks or wheel events from this frame (other events, like
+     *  keys and text, still reach them). A widget found outside is first
+     *  sent one mouse move off of itself, so that it stops showing any
+     *  hover. This is useful for frames much larger than what is shown
+     *  (for instance, scrolled or paged content).
+     *  @note drawing is culled automatically using the target's view, this
+     *        clip is only needed for events
+     *  @param area in the same coordinates as the widgets' locations
+     */
+    void set_event_clip(const sf::FloatRect & area);
+
+    /** Allows all visible widgets to receive events again. (default) */
+    void clear_event_clip();
+
+    /** @brief Adds a keyboard shortcut to this frame.
+     *
+     *  Accelerators are checked once for each key press, before any widget
+     *  sees the event. If one matches, its function is called and no widget
+     *  in this frame will receive that event.
+     *  @param key       key which triggers the accelerator
+     *  @param modifiers combination of AcceleratorTable::Modifier values, all
+     *                   of which (and no others) must be held
+     *  @param f         function that takes no arguments, any return value
+     *                   is ignored
+     */
+    template <typename Func>
+    void add_accelerator(sf::Keyboard::Key key, std::uint8_t modifiers, Func && f);
+
+    /** Removes a keyboard shortcut previously added to this frame, does
+     *  nothing if there is no such shortcut.
+     */
+    void remove_accelerator(sf::Keyboard::Key key, std::uint8_t modifiers);
+
+    /** @brief Has this frame render itself and its widgets to an off-screen
+     *         texture, which is then drawn as a single sprite.
+     *
+     *  The texture is only re-rendered when this frame or any of its widgets
+     *  requests a redraw (or the frame's layout changes). This is worthwhile
+     *  for mostly static frames which are drawn every frame. Disabled by
+     *  default.
+     *  @note this frame's background should be opaque for the cached image
+     *        to look the same as drawing directly
+     */
+    void enable_render_cache();
+
+    /** Draws this frame and its widgets directly to the target. (default) */
+    void disable_render_cache();
+
+    bool has_render_cache_enabled() const noexcept
+        { return bool(m_render_cache); }
+
+    /** @brief Has this frame count its draw calls, vertices and so on, into
+     *         the given stats each time it's drawn.
+     *
+     *  The stats are reset at the start of each draw, so that they hold the
+     *  counts for the most recent one. Each widget (including those of
+     *  nested frames) is counted as a subtree.
+     *  @param stats may be nullptr to stop counting (default), not owned by
+     *         the frame
+     */
+    void set_render_stats(RenderStats * stats) noexcept
+        { m_render_stats = stats; }
+
+    /** @brief Redraws only the parts of this frame which changed since the
+     *         last call, for targets whose contents persist from one frame
+     *         to the next (that is, are not cleared).
+     *
+     *  A widget requesting a redraw damages its area (both where it was
+     *  drawn last and where it is now). Changes to the frame itself, which
+     *  include any change in layout, damage the whole frame. Damaged areas
+     *  are merged, and each is then drawn through a view clipped to it, so
+     *  only intersecting widgets are drawn. The first call draws everything.
+     *  @note The target's view should not be rotated.
+     *  @param background if not fully transparent, damaged areas are filled
+     *         with this color first, which is needed if the frame may move
+     *         off of areas it used to cover
+     *  @returns the damaged areas which were redrawn (aligned to whole
+     *           pixels), empty if nothing changed
+     */
+    const std::vector<sf::FloatRect> & draw_damaged
+        (sf::RenderTarget &, sf::Color background = sf::Color::Transparent);
+
     // <---------------------- Frame border/title stuff ---------------------->
 
     /** Sets the title of the frame.
@@ -287,8 +385,11 @@ protected:
     Frame(const Frame &);
     Frame(Frame &&);
 
-    /** Draws the frame and all it's constintuate widgets.
+    /** Draws the frame and all it's constintuate widgets. Widgets which are
+     *  entirely outside of the target's current view are skipped. Widget
+     *  geometry is batched so that it takes only a few draw calls.
      *  @param target the SFML rendering target
+     *  @see Frame::enable_render_cache
      */
     void draw(sf::RenderTarget & target, sf::RenderStates) const override;
 
@@ -342,6 +443,29 @@ private:
 
     void check_invarients() const;
 
+    void draw_contents(DrawBatch &, const sf::FloatRect & visible_area) const;
+
+    /** Draws this frame's render cache, re-rendering it first if needed. */
+    void draw_from_cache(DrawBatch &) const;
+
+    /** Checks (and turns off) redraw requests from this frame and all its
+     *  widgets. Nested frames hold onto their own requests so that they may
+     *  also cache.
+     *  @return true if anything requested a redraw
+     */
+    bool poll_redraw_requests() const;
+
+    /** Polls the redraw requests of a widget and all of its descendants,
+     *  frames are polled with poll_redraw_requests.
+     *  @return true if anything requested a redraw
+     */
+    static bool poll_subtree_redraw_requests(const Widget &);
+
+    /** Turns off redraw requests much like poll_redraw_requests, only adding
+     *  each requesting widget's area (last drawn and present) as damage.
+     */
+    void collect_damage(std::vector<sf::FloatRect> &);
+
     std::vector<Widget *> m_widgets;
     float m_padding = styles::get_unset_value<float>();
     // anything related to the frame's border
@@ -353,6 +477,26 @@ private:
     FrameBorder m_border;
 
     detail::FrameFocusHandler m_focus_handler;
+
+    AcceleratorTable m_accelerators;
+
+    sf::FloatRect m_event_clip;
+    bool m_has_event_clip = false;
+    // by widget, true if outside the clip as of the last mouse event
+    std::vector<bool> m_event_clipped;
+
+    // render cache, present only if enabled, texture is (re)created lazily
+    // while drawing
+    std::unique_ptr<sf::RenderTexture> m_render_cache;
+    mutable bool m_render_cache_dirty = true;
+
+    RenderStats * m_render_stats = nullptr;
+
+    // damage tracking, see draw_damaged
+    std::vector<sf::FloatRect> m_damage;
+    // areas as of the last collection, parallel to m_widgets
+    std::vector<sf::FloatRect> m_drawn_bounds;
+    sf::FloatRect m_drawn_frame_bounds;
 };
 
 /** A Simple Frame allows creation of frames without being inherited. This can
@@ -367,11 +511,15 @@ public:
 
 // ----------------------------------------------------------------------------
 
-inline void Frame::set_title(const UString & title)
-    { m_border.set_title(title); }
+inline void Frame::set_title(const UString & title) {
+    m_border.set_title(title);
+    request_redraw();
+}
 
-inline void Frame::set_title_size(int font_size)
-    { m_border.set_title_size(font_size); }
+inline void Frame::set_title_size(int font_size) {
+    m_border.set_title_size(font_size);
+    request_redraw();
+}
 
 inline void Frame::set_drag_enabled(bool b) {
     if (b) m_border.watch_for_drag_events();
@@ -388,4 +536,13 @@ void Frame::set_register_click_event(Func && f)
 inline void Frame::reset_register_click_event()
     { m_border.reset_register_click_event(); }
 
+template <typename Func>
+void Frame::add_accelerator
+    (sf::Keyboard::Key key, std::uint8_t modifiers, Func && f)
+{ m_accelerators.insert(key, modifiers, [f = std::move(f)]() mutable { f(); }); }
+
+inline void Frame::remove_accelerator
+    (sf::Keyboard::Key key, std::uint8_t modifiers)
+    { m_accelerators.erase(key, modifiers); }
+
 } // end of ksg namespace
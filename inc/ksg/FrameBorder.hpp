@@ -60,6 +60,8 @@ public:
 
     void set_style(const StyleMap &) override {}
 
+    void draw_to_batch(DrawBatch &) const override {}
+
 private:
     void draw(sf::RenderTarget &, sf::RenderStates) const override {}
 };
@@ -82,6 +84,8 @@ public:
 
     void set_style(const StyleMap &) override {}
 
+    void draw_to_batch(DrawBatch &) const override {}
+
 private:
     void draw(sf::RenderTarget &, sf::RenderStates) const override {}
 
@@ -170,6 +174,11 @@ public:
 
     void set_border_size(float pixels);
 
+    /** Adds the border's (and title's) geometry to the batch, rather than
+     *  drawing it.
+     */
+    void draw_to_batch(DrawBatch &) const;
+
 private:
     void update_drag_position(int drect_x, int drect_y) override;
 
@@ -0,0 +1,208 @@
+/****************************************************************************
+
+    File: GlyphAtlas.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Glyph.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <ksg/ImageAtlas.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace ksg {
+
+/** @brief Holds glyphs of every font and character size together on shared
+ *         pages.
+ *
+ *  SFML keeps a separate texture for each character size of a font, so text
+ *  of different sizes can never be drawn together. Glyphs are still
+ *  rasterized by SFML, but are then copied onto this atlas' pages, so that
+ *  a frame's text (whatever its sizes) is usually drawn in one call.
+ *
+ *  Copying requires reading glyphs back from video memory, this is done at
+ *  most once per font and size for each call to prepare, and only for the
+ *  glyphs being added (which are first gathered onto a small target).
+ *
+ *  Glyphs may also be kept as signed distance fields, which are rasterized
+ *  once (at k_sdf_base_size) and then drawn at any scale with sdf_shader.
+ *  These are kept on pages of their own, which are smoothed.
+ *  @note render thread only
+ *  @note fonts are known by address, forget_font should be called before a
+ *        font is destroyed if any of its glyphs were added
+ */
+class GlyphAtlas final {
+public:
+    using UString = std::u32string;
+    using UStringConstIter = UString::const_iterator;
+
+    struct Entry {
+        //! as given by SFML, except that the texture rectangle is on the page
+        sf::Glyph glyph;
+        //! nullptr for glyphs with nothing to draw (e.g. spaces)
+        const sf::Texture * texture = nullptr;
+    };
+
+    //! character size distance fields are made from
+    static constexpr const unsigned k_sdf_base_size = 48;
+
+    //! furthest distance (in pixels at the base size) a field encodes, which
+    //! is also the padding around each distance field glyph
+    static constexpr const unsigned k_sdf_spread = 6;
+
+    /** @returns the process wide atlas, which Text uses */
+    static GlyphAtlas & instance();
+
+    /** Loads the shader on first use (and so needs a graphics context).
+     *  @returns the shader which draws distance field glyphs, or nullptr if
+     *           shaders are not available
+     */
+    static const sf::Shader * sdf_shader();
+
+    explicit GlyphAtlas(unsigned page_size = ImageAtlas::k_default_page_size);
+
+    GlyphAtlas(const GlyphAtlas &) = delete;
+
+    GlyphAtlas & operator = (const GlyphAtlas &) = delete;
+
+    /** Adds every glyph of the given characters not already present.
+     *  (regular style only)
+     */
+    void prepare(const sf::Font &, unsigned character_size,
+                 UStringConstIter beg, UStringConstIter end);
+
+    /** @returns a glyph's entry, adding the glyph if it is not present
+     *  @note prefer calling prepare for a whole string first, as each glyph
+     *        added alone costs a read back
+     */
+    const Entry & glyph(const sf::Font &, unsigned character_size, char32_t);
+
+    /** Adds every distance field glyph of the given characters not already
+     *  present.
+     */
+    void prepare_sdf(const sf::Font &, UStringConstIter beg, UStringConstIter end);
+
+    /** @returns a distance field glyph's entry, adding it if not present
+     *  @note bounds, advance and texture rectangle are all at the base size,
+     *        bounds include the spread around the glyph
+     */
+    const Entry & sdf_glyph(const sf::Font &, char32_t);
+
+    /** @returns true for the characters which fixed_advance and
+     *           kerning_table probe (printable ASCII)
+     */
+    static bool is_metrics_sample(char32_t c) noexcept
+        { return c >= U' ' && c <= U'~'; }
+
+    /** @brief Every kerned pair among the sample characters of one font at
+     *         one character size.
+     *
+     *  SFML cannot list a font's kerning pairs, so these are found by
+     *  probing each pair of sample characters once. An empty table says
+     *  nothing of pairs beyond the sample, which may still be kerned.
+     */
+    struct KerningTable {
+        // first in the upper byte, second in the lower
+        using PairKey = std::uint16_t;
+
+        struct Pair {
+            PairKey key = 0;
+            float amount = 0.f;
+        };
+
+        static PairKey make_key(char32_t first, char32_t second) noexcept
+            { return PairKey(((first & 0xFF) << 8) | (second & 0xFF)); }
+
+        /** @returns kerning between two sample characters, zero if the pair
+         *           is not kerned
+         */
+        float amount(char32_t first, char32_t second) const noexcept;
+
+        bool is_empty() const noexcept { return pairs.empty(); }
+
+        // sorted by key, for binary searching
+        std::vector<Pair> pairs;
+    };
+
+    /** Probed once per font and size.
+     *  @returns the kerning table, which remains valid until the font is
+     *           forgotten
+     */
+    const KerningTable & kerning_table(const sf::Font &, unsigned character_size);
+
+    /** Worked out once per font and size, which rasterizes the sample.
+     *  @returns the advance shared by every sample character, if they all
+     *           share one with no kerning between any of them (that is the
+     *           font is monospaced), otherwise zero
+     */
+    float fixed_advance(const sf::Font &, unsigned character_size);
+
+    /** Forgets the glyphs of a font (and any shared text layouts using
+     *  them), their space on the pages is not reclaimed.
+     */
+    void forget_font(const sf::Font &);
+
+    std::size_t glyph_count() const noexcept;
+
+    const ImageAtlas & pages() const noexcept { return m_pages; }
+
+    const ImageAtlas & sdf_pages() const noexcept { return m_sdf_pages; }
+
+private:
+    // character size in the upper half, code point in the lower, distance
+    // field glyphs use a character size of zero
+    using Key = std::uint64_t;
+    using EntryMap = std::unordered_map<Key, Entry>;
+
+    struct FontRecord {
+        EntryMap entries;
+        // by character size
+        std::unordered_map<unsigned, float> fixed_advances;
+        std::unordered_map<unsigned, KerningTable> kerning_tables;
+    };
+
+    static Key make_key(unsigned character_size, char32_t c) noexcept
+        { return (Key(character_size) << 32) | Key(c); }
+
+    void prepare_(const sf::Font &, unsigned character_size,
+                  UStringConstIter beg, UStringConstIter end, bool as_sdf);
+
+    // copies the given glyphs from a font's texture to where they are
+    // staged, and reads them back
+    sf::Image stage_glyphs(const sf::Texture & font_page, sf::Vector2u size,
+                           const EntryMap &, const std::vector<Key> &,
+                           const std::vector<sf::Vector2i> & staged_at);
+
+    // glyphs to be read back are staged in rows at most this wide
+    static constexpr const unsigned k_staging_width = 512;
+
+    std::unordered_map<const sf::Font *, FontRecord> m_fonts;
+    ImageAtlas m_pages;
+    ImageAtlas m_sdf_pages;
+    sf::RenderTexture m_staging;
+};
+
+} // end of ksg namespace
@@ -0,0 +1,117 @@
+/****************************************************************************
+
+    File: GlyphSource.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <ksg/GlyphAtlas.hpp>
+
+#include <string>
+
+namespace ksg {
+
+class BitmapFont;
+
+namespace detail {
+
+/** @brief Where a text's glyphs and metrics come from, at one character size.
+ *
+ *  This is either an SFML font (whose glyphs are regular or distance fields
+ *  on the glyph atlas), or a bitmap font (whose glyphs are on its own
+ *  pages). Either way, glyphs are given scaled to the character size and
+ *  with the texture they are on.
+ *
+ *  Monospaced fonts are detected (once per font and size), for these
+ *  advances of printable ASCII characters need no glyph lookups, and text
+ *  made only of them is measured as its length times the fixed advance
+ *  (after checking each character is in the sample, no lookups of any
+ *  kind). Kerning of SFML fonts is likewise probed once into a compact
+ *  table, text whose pairs cannot be kerned needs no pair lookups at all.
+ */
+class GlyphSource final {
+public:
+    using UStringConstIter = std::u32string::const_iterator;
+    using Entry = GlyphAtlas::Entry;
+
+    GlyphSource(const sf::Font &, int character_size, bool as_sdf);
+
+    GlyphSource(const BitmapFont &, int character_size);
+
+    /** Adds glyphs of the given characters to the glyph atlas, if they are
+     *  not already present. (nothing is done for bitmap fonts)
+     */
+    void prepare(UStringConstIter beg, UStringConstIter end) const;
+
+    Entry glyph(char32_t) const;
+
+    float advance_of(char32_t) const;
+
+    float kerning(char32_t first, char32_t second) const;
+
+    /** @returns false if kerning between any of the given characters is
+     *           always zero, so that pairs need not be looked up at all
+     *  @note only kerning of printable ASCII pairs is known ahead of time
+     *        for SFML fonts, so any other character is taken to be kerned
+     */
+    bool has_kerning(UStringConstIter beg, UStringConstIter end) const;
+
+    /** @returns the advance shared by printable ASCII characters, or zero if
+     *           the font is not monospaced
+     */
+    float fixed_advance() const noexcept { return m_fixed_advance; }
+
+    float line_spacing() const;
+
+    /** @returns distance from the top of a line to its baseline */
+    float baseline() const;
+
+    /** Measures a single line's width, including kerning.
+     *  @note with a fixed advance, and only printable ASCII characters,
+     *        this is a range check per character and one multiplication
+     */
+    float measure_width(UStringConstIter beg, UStringConstIter end) const;
+
+    float maximum_height(UStringConstIter beg, UStringConstIter end) const;
+
+    /** @returns shader glyphs must be drawn with, or nullptr if none */
+    const sf::Shader * shader() const;
+
+    int character_size() const noexcept { return m_character_size; }
+
+private:
+    // metrics only, which for SFML fonts skips the glyph atlas
+    sf::Glyph metrics_of(char32_t) const;
+
+    const sf::Font * m_font = nullptr;
+    const BitmapFont * m_bitmap_font = nullptr;
+    int m_character_size;
+    // size metrics are asked of the font at (SFML fonts only)
+    unsigned m_metrics_size = 0;
+    bool m_as_sdf = false;
+    // from baked (or distance field base) size to the character size
+    float m_scale = 1.f;
+    float m_fixed_advance = 0.f;
+    // SFML fonts only, nullptr if there is no character size
+    const GlyphAtlas::KerningTable * m_kerning_table = nullptr;
+};
+
+} // end of detail namespace
+
+} // end of ksg namespace
@@ -0,0 +1,124 @@
+/****************************************************************************
+
+    File: ImageAtlas.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+#include <memory>
+
+namespace ksg {
+
+/** @brief Packs many (usually small) images into a few large textures
+ *         ("pages").
+ *
+ *  Image widgets showing regions from the same page share a texture, so when
+ *  drawn by a frame they are batched together into a single draw call.
+ *
+ *  Images are packed onto shelves (rows) of each page, an image goes onto the
+ *  shelf which wastes the least height, a new shelf or page is started only
+ *  if no shelf fits. Regions are separated by a transparent pixel so that
+ *  smoothing does not bleed neighbors together.
+ *  @note Regions are never freed, an atlas is best for a set of images that
+ *        live as long as the atlas itself (icons for instance).
+ */
+class ImageAtlas final {
+public:
+    static constexpr const unsigned k_default_page_size = 1024;
+
+    struct Region {
+        //! the page's texture, which lives as long as the atlas
+        const sf::Texture * texture = nullptr;
+        sf::IntRect texture_rectangle;
+        std::size_t page = 0;
+    };
+
+    /** @param page_size width and height of each page in pixels, which is
+     *         limited to what the graphics driver supports
+     */
+    explicit ImageAtlas(unsigned page_size = k_default_page_size);
+
+    ImageAtlas(const ImageAtlas &) = delete;
+
+    ImageAtlas & operator = (const ImageAtlas &) = delete;
+
+    /** Packs and uploads an image.
+     *  @throws if the image is empty or cannot fit onto a page
+     */
+    Region add_image(const sf::Image &);
+
+    /** Loads an image from a file, and then packs it.
+     *  @throws if the image cannot be loaded or cannot fit onto a page
+     */
+    Region add_image_from_file(const std::string & filename);
+
+    std::size_t page_count() const noexcept { return m_pages.size(); }
+
+    unsigned page_size() const noexcept { return m_page_size; }
+
+    const sf::Texture & page_texture(std::size_t page) const;
+
+    /** Sets smoothing for every page, present and future. (off by default) */
+    void set_smooth(bool);
+
+    bool is_smooth() const noexcept { return m_smooth; }
+
+    /** @returns ratio of pixels used by images to the pixels of all pages, or
+     *           zero if there are no pages
+     */
+    double packing_efficiency() const noexcept;
+
+private:
+    static constexpr const unsigned k_padding = 1;
+
+    struct Shelf {
+        unsigned top = 0, height = 0;
+        //! next free x position
+        unsigned end = 0;
+    };
+
+    struct Page {
+        // textures are held by pointer so that regions refer to stable
+        // addresses
+        std::unique_ptr<sf::Texture> texture;
+        std::vector<Shelf> shelves;
+        //! bottom of the last shelf
+        unsigned used_height = 0;
+    };
+
+    /** @returns true if a place was found, writing out the page index and
+     *           position
+     */
+    bool find_place(unsigned w, unsigned h, std::size_t & page_idx,
+                    sf::Vector2u & pos);
+
+    void add_page();
+
+    std::vector<Page> m_pages;
+    unsigned m_page_size;
+    std::size_t m_used_area = 0;
+    bool m_smooth = false;
+};
+
+} // end of ksg namespace
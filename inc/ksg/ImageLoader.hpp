@@ -0,0 +1,120 @@
+/****************************************************************************
+
+    File: ImageLoader.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace ksg {
+
+class ImageWidget;
+
+namespace detail {
+
+/** One file being loaded, shared by the loader and the widget waiting on it.
+ */
+struct PendingImageLoad {
+    std::string filename;
+
+    // written by a worker only, and read only once the load is finished
+    sf::Image image;
+    bool decoded = false;
+
+    // set by the render thread when the widget no longer wants the image
+    std::atomic_bool cancelled { false };
+
+    // render thread only, the widget which receives the texture
+    ImageWidget * owner = nullptr;
+};
+
+} // end of detail namespace
+
+/** @brief Decodes image files on a pool of worker threads, and then uploads
+ *         them as textures on the render thread.
+ *
+ *  Decoding is the slow part of loading an image, and is done entirely off
+ *  of the render thread. Uploading must be done on the render thread (which
+ *  owns the graphics context), and so is done only when asked, a bounded
+ *  number of uploads at a time, so that no single frame stalls.
+ *  @code
+// once per frame, on the render thread
+ksg::ImageLoader::instance().upload_finished();
+window.clear();
+window.draw(frame);
+    @endcode
+ *  @see ImageWidget::load_from_file_async
+ */
+class ImageLoader final {
+public:
+    using PendingPtr = std::shared_ptr<detail::PendingImageLoad>;
+
+    static constexpr const std::size_t k_default_uploads_per_frame = 2;
+
+    /** @returns the process wide loader, which ImageWidget uses */
+    static ImageLoader & instance();
+
+    /** @returns a worker count leaving one hardware thread for rendering */
+    static std::size_t default_worker_count();
+
+    explicit ImageLoader(std::size_t worker_count = default_worker_count());
+
+    ImageLoader(const ImageLoader &) = delete;
+
+    /** Stops all workers, waiting only for decodes already under way. */
+    ~ImageLoader();
+
+    ImageLoader & operator = (const ImageLoader &) = delete;
+
+    /** (render thread only) Queues a file to be decoded for a widget. */
+    PendingPtr load(const std::string & filename, ImageWidget & owner);
+
+    /** @brief (render thread only) Uploads decoded images to their widgets.
+     *  @param max_uploads most textures to upload in this call
+     *  @returns the number of textures uploaded
+     */
+    std::size_t upload_finished
+        (std::size_t max_uploads = k_default_uploads_per_frame);
+
+    /** @returns number of loads not yet uploaded (decoded or otherwise) */
+    std::size_t pending_count() const;
+
+private:
+    void run_worker();
+
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_job_added;
+    std::deque<PendingPtr> m_jobs;
+    std::deque<PendingPtr> m_finished;
+    bool m_stopping = false;
+};
+
+} // end of ksg namespace
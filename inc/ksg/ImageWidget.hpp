@@ -30,6 +30,8 @@
 #include <common/MultiType.hpp>
 
 #include <ksg/Widget.hpp>
+#include <ksg/ImageAtlas.hpp>
+#include <ksg/ImageLoader.hpp>
 
 namespace ksg {
 
@@ -38,22 +40,73 @@ public:
     using TextureMultiType =
         MultiType<const sf::Texture *, std::shared_ptr<const sf::Texture>, sf::Texture>;
 
+    ImageWidget() {}
+
+    /** Copies what's shown, but not any load still pending. */
+    ImageWidget(const ImageWidget &);
+
+    ImageWidget(ImageWidget &&);
+
+    ~ImageWidget() override;
+
+    ImageWidget & operator = (const ImageWidget &);
+
+    ImageWidget & operator = (ImageWidget &&);
+
+    /** Loads (or reuses) the file's texture from the process wide texture
+     *  cache, so widgets showing the same file share one texture.
+     *  @returns false if the file cannot be loaded, or the cache fails to
+     *           hold it, in which case the widget is unchanged
+     */
     bool load_from_file(const char * filename) noexcept;
 
+    /** @brief Loads an image without blocking, it is decoded on one of the
+     *         image loader's workers, and is shown once uploaded.
+     *
+     *  Nothing is shown until then. Setting any other texture before the
+     *  upload cancels the load, as does destroying the widget. If the image
+     *  cannot be loaded, the widget stays empty. Files already in the texture
+     *  cache are shown immediately.
+     *  @note ImageLoader::upload_finished must be called regularly on the
+     *        render thread (the thread calling this)
+     *  @param placeholder_size size to use meanwhile (and afterward), a zero
+     *         vector keeps the present size
+     */
+    void load_from_file_async(const std::string & filename,
+                              VectorF placeholder_size = VectorF());
+
+    /** @returns true if an asynchronous load has not yet been uploaded */
+    bool has_pending_load() const noexcept
+        { return m_pending && m_pending->owner == this; }
+
     void load_from_image(const sf::Image & image);
 
+    /** Copies the texture, which is a round trip through video memory.
+     *  Prefer the other overloads or the texture cache where possible.
+     */
     void set_texture(const sf::Texture & texture_,
                      const sf::IntRect & trect_ = sf::IntRect());
 
+    /** Takes the texture without copying it. */
+    void set_texture(sf::Texture && texture_,
+                     const sf::IntRect & trect_ = sf::IntRect());
+
+    /** Shares ownership of the texture, nullptr shows nothing. */
     void set_texture_shared_pointer(std::shared_ptr<const sf::Texture>);
 
     /** Assigns a pointer to the texture, with the client being responsible for
-     *  ownership.
+     *  ownership. nullptr shows nothing.
      *  @note the given pointed to object must live at least as long as this
      *        widget, or bad things will happen!
      */
     void assign_texture(const sf::Texture *);
 
+    /** Shows a region of an atlas' page. Widgets showing regions of the same
+     *  page are drawn together by their frame.
+     *  @note the atlas must live at least as long as this widget
+     */
+    void set_atlas_region(const ImageAtlas::Region &);
+
     void reset_texture_rectangle(const sf::IntRect & trect_);
 
     void process_event(const sf::Event &) override {}
@@ -70,6 +123,8 @@ public:
 
     void set_style(const StyleMap &) override {}
 
+    void draw_to_batch(DrawBatch &) const override;
+
 private:
     void draw(sf::RenderTarget & target, sf::RenderStates states) const override;
 
@@ -77,9 +132,19 @@ private:
 
     void update_size_post_load();
 
+    void cancel_pending_load();
+
+    // shows nothing, keeping the location and size
+    void unset_texture();
+
+    // needed after copying, as the sprite still refers to the source's
+    // texture if it is stored by value
+    void update_sprite_texture();
+
     TextureMultiType m_texture_storage;
     sf::Sprite   m_spt;
     sf::Vector2f m_size;
+    ImageLoader::PendingPtr m_pending;
 };
 
 } // end of ksg namespace
@@ -80,6 +80,8 @@ public:
 
     void set_wrap_enabled(bool);
 
+    void draw_to_batch(DrawBatch &) const override;
+
 private:
     void draw(sf::RenderTarget & target, sf::RenderStates) const override;
 
@@ -63,6 +63,8 @@ public:
     float padding() const
         { return m_padding; }
 
+    void draw_to_batch(DrawBatch &) const override;
+
 protected:
     void draw(sf::RenderTarget & target, sf::RenderStates) const override;
 
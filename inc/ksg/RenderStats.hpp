@@ -0,0 +1,132 @@
+/****************************************************************************
+
+    File: RenderStats.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+namespace sf { class Texture; }
+
+namespace ksg {
+
+class Widget;
+
+/** @brief Counts what it costs to draw: draw calls, vertices, primitive
+ *         types and texture switches, in total and per widget subtree.
+ *
+ *  Counting is done by the DrawBatch frames draw with, so nothing is
+ *  counted unless a frame is given these stats to fill.
+ *
+ *  Drawables drawn unbatched (widgets without their own draw_to_batch) are
+ *  opaque to this, each is counted as one draw call of unknown size,
+ *  primitive type and texture (which is assumed to be a switch).
+ *
+ *  For subtrees, vertices are those the subtree added, while draw calls are
+ *  those made while the subtree was being drawn. Batched geometry shares its
+ *  draw calls, these fall to whichever subtree flushes the batch (or to none
+ *  if it is flushed after all the widgets).
+ *  @code
+ksg::RenderStats stats;
+frame.set_render_stats(&stats);
+// ...
+window.draw(frame);
+if (stats.totals().draw_calls > k_draw_call_budget) {
+    // ...
+}
+    @endcode
+ */
+class RenderStats final {
+public:
+    static constexpr const std::size_t k_primitive_type_count = sf::Quads + 1;
+
+    struct Counts {
+        std::size_t draw_calls       = 0;
+        std::size_t vertices         = 0;
+        std::size_t texture_switches = 0;
+        //! draws whose contents are unknown, these are also draw calls
+        std::size_t unbatched_draws  = 0;
+        //! draw calls indexed by sf::PrimitiveType
+        std::array<std::size_t, k_primitive_type_count> primitive_draws {};
+    };
+
+    /** Counts one draw call of known vertices. */
+    void record_draw(sf::PrimitiveType, std::size_t vertex_count,
+                     const sf::Texture *);
+
+    /** Counts one draw call of an unknown drawable. */
+    void record_unbatched_draw();
+
+    /** Counts vertices added to a batch, only toward subtrees. The totals
+     *  count vertices once they're drawn.
+     */
+    void record_added_vertices(std::size_t vertex_count);
+
+    /** Makes everything counted until the matching pop also count toward this
+     *  widget's subtree. Subtrees may nest.
+     */
+    void push_subtree(const Widget &);
+
+    void pop_subtree();
+
+    /** Clears all counts, done by the root frame at the start of each draw. */
+    void reset();
+
+    const Counts & totals() const noexcept { return m_totals; }
+
+    /** @returns the counts for the widget's subtree, or nullptr if it was not
+     *           drawn since the last reset
+     */
+    const Counts * subtree_counts(const Widget &) const;
+
+private:
+    void record_texture(const sf::Texture *, bool is_known);
+
+    Counts m_totals;
+    // pointers to elements in an unordered map stay valid on insertion
+    std::unordered_map<const Widget *, Counts> m_subtrees;
+    std::vector<Counts *> m_active_subtrees;
+
+    const sf::Texture * m_last_texture = nullptr;
+    bool m_last_texture_known = false;
+};
+
+/** Pushes a subtree for its lifetime, does nothing given nullptr for stats. */
+class ScopedRenderSubtree final {
+public:
+    ScopedRenderSubtree(RenderStats * stats, const Widget & widget):
+        m_stats(stats)
+    { if (m_stats) m_stats->push_subtree(widget); }
+
+    ScopedRenderSubtree(const ScopedRenderSubtree &) = delete;
+
+    ScopedRenderSubtree & operator = (const ScopedRenderSubtree &) = delete;
+
+    ~ScopedRenderSubtree() { if (m_stats) m_stats->pop_subtree(); }
+
+private:
+    RenderStats * m_stats;
+};
+
+} // end of ksg namespace
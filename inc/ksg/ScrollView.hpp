@@ -0,0 +1,116 @@
+/****************************************************************************
+
+    File: ScrollView.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <ksg/Widget.hpp>
+
+#include <SFML/Graphics/Rect.hpp>
+
+namespace ksg {
+
+/** @brief Shows part of a (larger) widget through a fixed size viewport,
+ *         which is scrolled with the mouse wheel.
+ *
+ *  The child widget is placed once at the view's location, scrolling then
+ *  only translates it while drawing (rather than moving every one of its
+ *  descendants). Drawing is clipped to the viewport, and widgets which cull
+ *  against DrawBatch::visible_area (e.g. frames and selection menus) draw
+ *  only what is in view.
+ *
+ *  Mouse events are given to the child in its own (unscrolled) coordinates,
+ *  those outside of the viewport are moved off of the child, so that
+ *  nothing hidden may be hovered or clicked.
+ *  @note the child is not owned by the view
+ */
+class ScrollView final : public Widget {
+public:
+    static constexpr const float k_default_scroll_step = 32.f;
+
+    /** Sets the widget to be scrolled, which must outlive this view (or be
+     *  unset first).
+     */
+    void set_child(Widget &);
+
+    void unset_child();
+
+    Widget * child() noexcept { return m_child; }
+
+    const Widget * child() const noexcept { return m_child; }
+
+    void process_event(const sf::Event &) override;
+
+    void set_location(float x, float y) override;
+
+    VectorF location() const override;
+
+    /** Sets the size of the viewport, if either dimension is zero the
+     *  child's is used for it instead.
+     */
+    void set_size(float width, float height);
+
+    float width() const override;
+
+    float height() const override;
+
+    void set_style(const StyleMap &) override;
+
+    void issue_auto_resize() override;
+
+    void draw_to_batch(DrawBatch &) const override;
+
+    /** Sets distance scrolled by each step of the mouse wheel. */
+    void set_scroll_step(float);
+
+    float scroll_step() const noexcept { return m_scroll_step; }
+
+    /** Scrolls so that the given point of the child is at the view's top
+     *  left, as near as the child's size permits.
+     */
+    void scroll_to(float x, float y);
+
+    void scroll_by(float dx, float dy);
+
+    VectorF scroll_offset() const noexcept { return m_offset; }
+
+    /** @returns the furthest the child may be scrolled */
+    VectorF maximum_scroll_offset() const;
+
+private:
+    void draw(sf::RenderTarget &, sf::RenderStates) const override;
+
+    void iterate_children_(ChildWidgetIterator &) override;
+
+    void iterate_const_children_(ChildWidgetIterator &) const override;
+
+    bool contains(int x, int y) const noexcept;
+
+    // maps a point on the view to where it is on the child, or off of the
+    // child if it is outside of the viewport
+    VectorF map_to_child(int x, int y) const;
+
+    Widget * m_child = nullptr;
+    sf::FloatRect m_bounds;
+    VectorF m_offset;
+    float m_scroll_step = k_default_scroll_step;
+};
+
+} // end of ksg namespace
@@ -26,12 +26,36 @@
 
 #include <common/DrawRectangle.hpp>
 
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <cstddef>
+
 namespace ksg {
 
 struct SelectionEntryReciever {
     virtual ~SelectionEntryReciever();
     virtual void activate(std::size_t menu_idx) = 0;
     virtual void deactivate(std::size_t menu_idx) = 0;
+
+    /** Called when an entry gains focus. (default does nothing) */
+    virtual void notify_focused(std::size_t menu_idx);
+
+    /** Entries may be reused for other indices, while keeping their focus.
+     *  @returns the index that an entry's focus is really on (default is
+     *           the entry's own index)
+     */
+    virtual std::size_t focused_index(std::size_t menu_idx) const;
+
+    /** Called when keyboard focus is about to leave a focused entry, so that
+     *  a menu showing only some of its options may scroll instead.
+     *  @param forward true if focus is advancing, false if regressing
+     *  @returns true if the entry should keep focus, as it now shows the
+     *           next (or previous) option (default is false)
+     */
+    virtual bool scroll_focus_past(std::size_t menu_idx, bool forward);
 };
 
 class SelectionEntry final : public FocusWidget {
@@ -68,6 +92,8 @@ public:
 
     // based on content, not the wrapping
     float content_height() const;
+
+    void draw_to_batch(DrawBatch &) const override;
 private:
     void draw(sf::RenderTarget &, sf::RenderStates) const override;
 
@@ -79,6 +105,9 @@ private:
 
     void update_highlight();
 
+    // true if focused, and focus is still on this entry's index
+    bool shows_focus() const;
+
     void recenter_text();
 
     float padding() const noexcept;
@@ -95,24 +124,145 @@ private:
     bool m_mouse_is_over = false;
 };
 
-// number of items may vary
+namespace detail {
+
+/** Iterates a menu's entries, which are kept by pointer, as the entries
+ *  themselves. (as they were once kept by value)
+ */
+class SelectionEntryIterator final {
+public:
+    using BaseIterator      = std::vector<SelectionEntry *>::iterator;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = SelectionEntry;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = SelectionEntry *;
+    using reference         = SelectionEntry &;
+
+    SelectionEntryIterator() {}
+
+    explicit SelectionEntryIterator(BaseIterator itr): m_itr(itr) {}
+
+    reference operator * () const { return **m_itr; }
+
+    pointer operator -> () const { return *m_itr; }
+
+    reference operator [] (difference_type n) const { return *m_itr[n]; }
+
+    SelectionEntryIterator & operator ++ () { ++m_itr; return *this; }
+
+    SelectionEntryIterator & operator -- () { --m_itr; return *this; }
+
+    SelectionEntryIterator operator ++ (int) { auto t = *this; ++m_itr; return t; }
+
+    SelectionEntryIterator operator -- (int) { auto t = *this; --m_itr; return t; }
+
+    SelectionEntryIterator & operator += (difference_type n) { m_itr += n; return *this; }
+
+    SelectionEntryIterator & operator -= (difference_type n) { m_itr -= n; return *this; }
+
+    SelectionEntryIterator operator + (difference_type n) const
+        { return SelectionEntryIterator(m_itr + n); }
+
+    SelectionEntryIterator operator - (difference_type n) const
+        { return SelectionEntryIterator(m_itr - n); }
+
+    difference_type operator - (const SelectionEntryIterator & rhs) const
+        { return m_itr - rhs.m_itr; }
+
+    bool operator == (const SelectionEntryIterator & rhs) const { return m_itr == rhs.m_itr; }
+
+    bool operator != (const SelectionEntryIterator & rhs) const { return m_itr != rhs.m_itr; }
+
+    bool operator <  (const SelectionEntryIterator & rhs) const { return m_itr <  rhs.m_itr; }
+
+    bool operator >  (const SelectionEntryIterator & rhs) const { return m_itr >  rhs.m_itr; }
+
+    bool operator <= (const SelectionEntryIterator & rhs) const { return m_itr <= rhs.m_itr; }
 
+    bool operator >= (const SelectionEntryIterator & rhs) const { return m_itr >= rhs.m_itr; }
+
+private:
+    BaseIterator m_itr;
+};
+
+} // end of detail namespace
+
+/** @brief A vertical list of options, one of which may be selected.
+ *
+ *  Options are either owned by the menu (add_options), or read from a data
+ *  source (set_data_source). Owned options may be inserted, erased and
+ *  replaced in place, only rows which move are placed again, and entries
+ *  are reused rather than the menu being rebuilt. (frames only give focus
+ *  to new entries once they finalize their widgets again)
+ *
+ *  With a data source, the menu is virtualized:
+ *  only as many entries as are visible are made, and these are reused for
+ *  other options as the menu is scrolled (by the mouse wheel, or by moving
+ *  keyboard focus past either end of the visible options), while
+ *  selection and focus are kept by option index.
+ *  @note keyboard scrolling follows the frame's default focus keys (tab and
+ *        shift + tab)
+ */
 class SelectionMenu final : public Widget, public SelectionEntryReciever {
 public:
     using UString       = Text::UString;
-    using EntryVector   = std::vector<SelectionEntry>;
-    using EntryIterator = EntryVector::iterator;
+    // in order of the rows they are on
+    using EntryVector   = std::vector<SelectionEntry *>;
+    using EntryIterator = detail::SelectionEntryIterator;
     using ResponseFunc  = std::function<void(std::size_t, const UString &)>;
+    using CountFunc     = std::function<std::size_t()>;
+    using OptionFunc    = std::function<UString(std::size_t)>;
 
     static constexpr const char * const k_max_highlight     = "selection-menu-max-highlight";
     static constexpr const char * const k_regular_highlight = "selection-menu-reg-highlight";
     static constexpr const char * const k_no_highlight      = "selection-menu-no-highlight";
 
+    /** Sets every option, reusing entries already made.
+     *  @throws if the menu has a data source
+     */
     void add_options(std::vector<UString> &&);
 
-    EntryIterator begin() { return m_entries.begin(); }
+    /** Inserts an option before the given index (which may be the number of
+     *  options), the menu grows by one row.
+     *  @throws if the menu has a data source
+     */
+    void insert_option(std::size_t index, UString &&);
+
+    /** @throws if the menu has a data source */
+    void erase_option(std::size_t index);
+
+    /** @throws if the menu has a data source */
+    void replace_option(std::size_t index, UString &&);
+
+    /** @brief Has the menu show options from a data source, rather than
+     *         owning them.
+     *
+     *  @param count_func gives the number of options
+     *  @param option_func gives the option at an index
+     *  @param visible_count number of options visible at once, which is also
+     *         the number of entries made
+     */
+    void set_data_source(CountFunc count_func, OptionFunc option_func,
+                         std::size_t visible_count);
+
+    /** Reads the option count, and the visible options again (for instance
+     *  after the data source changes).
+     */
+    void refresh_data_source();
+
+    bool has_data_source() const noexcept { return bool(m_count_func); }
+
+    std::size_t option_count() const;
+
+    /** Scrolls (if needed) so that the option is visible. */
+    void scroll_to_option(std::size_t index);
+
+    /** @returns index of the first visible option */
+    std::size_t first_visible_option() const noexcept { return m_first_visible; }
+
+    EntryIterator begin() { return EntryIterator(m_entries.begin()); }
 
-    EntryIterator end() { return m_entries.end(); }
+    EntryIterator end() { return EntryIterator(m_entries.end()); }
 
     template <typename Func>
     void set_response_function(Func && f) { m_resp_func = std::move(f); }
@@ -143,14 +293,57 @@ private:
 
     void draw(sf::RenderTarget &, sf::RenderStates) const override;
 
+    void draw_to_batch(DrawBatch &) const override;
+
     void activate(std::size_t) override;
 
     void deactivate(std::size_t) override;
 
+    void notify_focused(std::size_t) override;
+
+    std::size_t focused_index(std::size_t) const override;
+
+    bool scroll_focus_past(std::size_t, bool forward) override;
+
     void issue_auto_resize() override;
 
+    // (re)binds every entry to the option it now shows
+    void bind_entries();
+
+    // places rows from the given one onward
+    void place_rows(std::size_t first);
+
+    SelectionEntry & make_entry();
+
+    void release_entry(SelectionEntry &);
+
+    void check_owns_options(const char * caller) const;
+
+    // clamped, so that no more entries than needed are past the last option
+    void set_first_visible(std::size_t);
+
+    std::size_t last_first_visible() const noexcept;
+
+    // moves the selection highlight to the selected option's entry, if it is
+    // visible
+    void update_selection_highlight();
+
+    float entry_height() const noexcept;
+
     ResponseFunc m_resp_func = default_response_function;
-    std::vector<SelectionEntry> m_entries;
+    // every entry ever made, a deque so that none ever move
+    std::deque<SelectionEntry> m_entry_store;
+    // hidden, and waiting to be reused
+    std::vector<SelectionEntry *> m_free_entries;
+    // with a data source, these are only the visible entries, which are
+    // reused for other options on scrolling
+    EntryVector m_entries;
+    std::shared_ptr<const StyleMap> m_styles;
+    CountFunc m_count_func;
+    OptionFunc m_option_func;
+    std::size_t m_option_count = 0;
+    std::size_t m_first_visible = 0;
+    std::size_t m_focused = k_uninit;
     sf::FloatRect m_bounds;
     DrawRectangle m_selected;
     std::size_t m_last_selected = k_uninit;
@@ -30,11 +30,15 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <chrono>
 
 namespace ksg {
 
+class BitmapFont;
+
 using StylesField = MultiType<
-    sf::Color, float, const sf::Font *, std::shared_ptr<const sf::Font>
+    sf::Color, float, const sf::Font *, std::shared_ptr<const sf::Font>,
+    const BitmapFont *, std::shared_ptr<const BitmapFont>
 >;
 
 class Text;
@@ -67,9 +71,50 @@ StyleMap construct_system_styles();
  *  @return a style field, which stores a shared_ptr to the loaded font,
  *          if loading the font failed, an empty styles field is returned
  *          instead
+ *  @note   once the last copy of the font is gone, the glyph atlas and
+ *          text layout cache forget it
  */
 StylesField load_font(const std::string & filename);
 
+/** @brief  Attempts to load a bitmap font (metrics file and its textures),
+ *          and store it into a styles field directly.
+ *  @param  filename of the font's metrics file
+ *  @return a style field, which stores a shared_ptr to the loaded font,
+ *          if loading the font failed, an empty styles field is returned
+ *          instead
+ *  @note   once the last copy of the font is gone, the text layout cache
+ *          forgets it
+ */
+StylesField load_bitmap_font(const std::string & filename);
+
+/** @returns printable ASCII characters (space through tilde) */
+std::u32string default_prewarm_characters();
+
+struct GlyphPrewarmReport {
+    std::size_t font_count = 0;
+    std::size_t size_count = 0;
+    std::size_t glyph_count = 0;
+    std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+};
+
+/** @brief Rasterizes characters ahead of time for every font and character
+ *         size named by a style map.
+ *
+ *  SFML rasterizes each glyph the first time it is used at each size, which
+ *  may also grow the font's texture, and then copies it onto the glyph
+ *  atlas, and so causes a hitch the first time new text is shown. This
+ *  does all of that up front, and is best called during a loading screen, with
+ *  the same styles later given to frames.
+ *  @note the font sizes used are those for frame titles, text areas (which
+ *        includes editable text and selection menus) and text buttons
+ *        (which includes option sliders)
+ *  @param smap style map whose global font and text sizes are to be used
+ *  @param characters characters to rasterize for each font and size
+ */
+GlyphPrewarmReport prewarm_glyphs
+    (const StyleMap & smap,
+     const std::u32string & characters = default_prewarm_characters());
+
 template <typename T, typename KeyType, typename std::enable_if<StylesField::HasType<T>::k_value && std::is_pointer<T>::value, T>::type...>
 auto find(const StyleMap & smap, const KeyType & key) {
     auto itr = smap.find(key);
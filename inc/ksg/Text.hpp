@@ -61,12 +61,15 @@
 
 #include <ksg/StyleMap.hpp>
 #include <ksg/DrawCharacter.hpp>
+#include <ksg/GlyphSource.hpp>
+#include <ksg/TextLayoutCache.hpp>
 
 namespace ksg {
 
 namespace detail {
 
-using FontMtPtr = MultiType<const sf::Font *, std::shared_ptr<const sf::Font>>;
+using FontMtPtr = MultiType<const sf::Font *, std::shared_ptr<const sf::Font>,
+                            const BitmapFont *, std::shared_ptr<const BitmapFont>>;
 
 } // end of detail namespace
 
@@ -78,9 +81,12 @@ using FontMtPtr = MultiType<const sf::Font *, std::shared_ptr<const sf::Font>>;
  *  be handled by this class.
  *
  *  Features:
- *  - can restrict it's text rendering to a rectangle.
+ *  - can restrict it's text rendering to a rectangle (characters partly
+ *    outside are clipped when drawn, rather than cut).
  *  - handles multi line text restricted by width.
  *  - automatic word wrapping (greedy) based on restricted width
+ *  - optional signed distance field glyphs, which stay sharp at any scale
+ *  - optional sharing of layouts between texts showing the same string
  */
 class Text final : public sf::Drawable {
 public:
@@ -129,11 +135,45 @@ public:
 
     void assign_font(const std::shared_ptr<const sf::Font> &);
 
+    void assign_font(const BitmapFont *);
+
+    void assign_font(const std::shared_ptr<const BitmapFont> &);
+
     template <typename KeyType>
     bool assign_font(const StyleMap &, const KeyType &);
 
     void set_color_for_character(int index, sf::Color clr);
 
+    /** @brief Draws with signed distance field glyphs, which are rasterized
+     *         once and shared by every character size.
+     *
+     *  Text may then be scaled (by transform or character size) without new
+     *  glyphs being rasterized. Metrics are those of the distance field
+     *  glyphs (scaled), and so may differ slightly from regular text.
+     *  @note if shaders are not available, regular glyphs are used instead,
+     *        bitmap fonts are always drawn with their own glyphs
+     */
+    void enable_sdf_rendering();
+
+    void disable_sdf_rendering();
+
+    /** @returns true if distance field glyphs are asked for (they may not be
+     *           available)
+     */
+    bool has_sdf_rendering_enabled() const noexcept { return m_sdf_requested; }
+
+    /** @brief Shares this text's layout with every other text (with sharing
+     *         enabled) of the same string, font, character size and limits.
+     *
+     *  Meant for labels repeated many times over (e.g. "OK" or column
+     *  headers), such texts then differ only in location and color.
+     */
+    void enable_shared_layout();
+
+    void disable_shared_layout();
+
+    bool has_shared_layout_enabled() const noexcept { return m_share_layout; }
+
     VectorF character_location(int index) const;
 
     VectorF location() const;
@@ -148,8 +188,14 @@ public:
 
     bool has_font_assigned() const;
 
+    /** @throws if no font is assigned, or if the font is a bitmap font */
     const sf::Font & assigned_font() const;
 
+    /** @returns the assigned bitmap font, or nullptr if the assigned font is
+     *           not a bitmap font
+     */
+    const BitmapFont * assigned_bitmap_font() const noexcept;
+
     /** @returns get_unset_value<int>() if character size is not yet set since
      *           object's creation.
      */
@@ -163,6 +209,11 @@ public:
 
     bool is_visible() const;
 
+    /** Adds this text's glyphs to the batch, using the font's texture for the
+     *  current character size, rather than drawing them one by one.
+     */
+    void draw_to_batch(DrawBatch &) const;
+
     static TextSize measure_text
         (const sf::Font &, unsigned character_size, const UString &);
 
@@ -190,26 +241,54 @@ private:
 
     const sf::Font * font_ptr() const noexcept;
 
-    void place_renderables(std::vector<detail::DrawableCharacter> &) const;
+    const BitmapFont * bitmap_font_ptr() const noexcept;
+
+    // font must be assigned
+    detail::GlyphSource glyph_source() const;
+
+    // true if distance field glyphs are both asked for and available
+    bool uses_sdf() const;
+
+    // layout is deferred, so that setting several properties in a row
+    // costs only one layout (done on the next read of geometry or draw)
+    void invalidate_geometry() noexcept { m_geometry_dirty = true; }
+
+    void refresh_geometry() const
+        { if (m_geometry_dirty) update_geometry(); }
+
+    void update_geometry() const;
+
+    // never changed once made, for it may be shared
+    std::shared_ptr<detail::TextLayout> make_layout() const;
 
-    // cuts/removes renderables that fall outside of width/height constraints
-    void cut_renderables(std::vector<detail::DrawableCharacter> &) const;
+    TextLayoutCache::Key make_layout_key() const;
 
-    void update_geometry();
+    // an empty layout if none has been made yet
+    const detail::TextLayout & layout() const noexcept;
 
     using FontMtPtr = detail::FontMtPtr;
     FontMtPtr m_font_ptr;
     UString m_string;
 
-    std::vector<detail::DrawableCharacter> m_renderables;
+    // geometry (layout, colors and size) is laid out lazily, and so is
+    // mutable
+    mutable std::shared_ptr<const detail::TextLayout> m_layout;
+    // the first color is always the text's own color
+    mutable std::vector<sf::Color> m_colors;
+    // color index of each glyph, empty while every glyph has the text's own
+    // color
+    mutable std::vector<detail::GlyphRecord::IndexType> m_glyph_colors;
     // next iterator to the next chunk of text alternating between
     // breakable and unbreakable
     std::vector<UString::const_iterator> m_next_chunk;
     int m_char_size = styles::get_unset_value<int>();
-    sf::FloatRect m_bounds;
+    mutable sf::FloatRect m_bounds;
+    mutable bool m_geometry_dirty = false;
     float m_width_constraint = k_inf;
     float m_height_constraint = k_inf;
     bool m_allow_bottom_cuts = false;
+    bool m_sdf_requested = false;
+    bool m_share_layout = false;
     sf::Color m_color;
 };
 
@@ -222,10 +301,14 @@ bool Text::assign_font(const StyleMap & map, const KeyType & key_type) {
         m_font_ptr = FontMtPtr(mt.template as<const sf::Font *>());
     } else if (mt.template is_type<std::shared_ptr<const sf::Font>>()) {
         m_font_ptr = FontMtPtr(mt.template as<std::shared_ptr<const sf::Font>>());
+    } else if (mt.template is_type<const BitmapFont *>()) {
+        m_font_ptr = FontMtPtr(mt.template as<const BitmapFont *>());
+    } else if (mt.template is_type<std::shared_ptr<const BitmapFont>>()) {
+        m_font_ptr = FontMtPtr(mt.template as<std::shared_ptr<const BitmapFont>>());
     } else {
         return false;
     }
-    update_geometry();
+    invalidate_geometry();
     return true;
 }
 
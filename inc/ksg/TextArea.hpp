@@ -67,10 +67,10 @@ public:
     const UString & string() const { return m_draw_text.string(); }
 
     void set_color_for_index(int index, sf::Color c)
-        { m_draw_text.set_color_for_character(index, c); }
+        { m_draw_text.set_color_for_character(index, c); request_redraw(); }
 
     void set_color(sf::Color c)
-        { m_draw_text.set_color(c); }
+        { m_draw_text.set_color(c); request_redraw(); }
 
     void set_character_size(int size_);
 
@@ -99,6 +99,8 @@ public:
     int character_size() const
         { return m_draw_text.character_size(); }
 
+    void draw_to_batch(DrawBatch &) const override;
+
 protected:
     void draw(sf::RenderTarget & target, sf::RenderStates) const override;
 
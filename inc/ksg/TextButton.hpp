@@ -45,6 +45,8 @@ public:
 
     void issue_auto_resize() override;
 
+    void draw_to_batch(DrawBatch &) const override;
+
 private:
     /** Sets the maximum size of the text button.
      *  @param w width in pixels
@@ -0,0 +1,114 @@
+/****************************************************************************
+
+    File: TextLayoutCache.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <ksg/DrawCharacter.hpp>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+namespace ksg {
+
+namespace detail {
+
+/** A text's glyphs as laid out, relative to its location. Once made a
+ *  layout is never changed, so that it may be shared by several texts.
+ */
+struct TextLayout {
+    std::vector<GlyphRecord> glyphs;
+    std::vector<GlyphQuad> quads;
+    float width = 0.f;
+    float height = 0.f;
+    // only used if some character crosses a constraint
+    sf::FloatRect clip_area;
+    bool needs_clip = false;
+};
+
+} // end of detail namespace
+
+/** @brief Process wide store of text layouts, so that texts showing the same
+ *         string, with the same font, size and limits, share one layout.
+ *
+ *  Only weak references are kept, a layout lives only as long as some text
+ *  uses it. Entries whose layouts have gone are pruned as the cache grows.
+ *  @note render thread only
+ *  @note fonts are known by address (as with the glyph atlas), forget_font
+ *        should be called before a font is destroyed
+ */
+class TextLayoutCache final {
+public:
+    using UString = std::u32string;
+    using LayoutPtr = std::shared_ptr<const detail::TextLayout>;
+
+    struct Key {
+        // either an SFML or bitmap font
+        const void * font = nullptr;
+        int character_size = 0;
+        bool as_sdf = false;
+        float width_constraint = 0.f;
+        float height_constraint = 0.f;
+        UString string;
+
+        bool operator == (const Key &) const noexcept;
+    };
+
+    static TextLayoutCache & instance();
+
+    TextLayoutCache() {}
+
+    TextLayoutCache(const TextLayoutCache &) = delete;
+
+    TextLayoutCache & operator = (const TextLayoutCache &) = delete;
+
+    /** @returns the layout for the key, or a null pointer if no text is
+     *           using one
+     */
+    LayoutPtr find(const Key &) const;
+
+    /** Adds a layout, replacing any which are no longer used. */
+    void insert(const Key &, LayoutPtr);
+
+    /** Forgets every layout of a font, texts using them keep them. */
+    void forget_font(const void * font);
+
+    std::size_t entry_count() const noexcept { return m_layouts.size(); }
+
+private:
+    struct KeyHasher {
+        std::size_t operator () (const Key &) const noexcept;
+    };
+
+    static constexpr const std::size_t k_min_prune_size = 64;
+
+    void prune_unused();
+
+    std::unordered_map<Key, std::weak_ptr<const detail::TextLayout>, KeyHasher>
+        m_layouts;
+    // pruning happens when the cache reaches this many entries
+    std::size_t m_prune_size = k_min_prune_size;
+};
+
+} // end of ksg namespace
@@ -0,0 +1,115 @@
+/****************************************************************************
+
+    File: TextureCache.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <SFML/Graphics/Texture.hpp>
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+
+namespace ksg {
+
+/** @brief Process wide store of textures loaded from files, keyed by path.
+ *
+ *  Every widget showing the same file shares one texture (and so one
+ *  upload). Textures held only by the cache are evicted, least recently
+ *  used first, whenever the cache holds more than its byte budget. Textures
+ *  still held elsewhere are never evicted, so the budget may be exceeded
+ *  while they are in use.
+ *  @note render thread only, as loading a texture uploads it
+ */
+class TextureCache final {
+public:
+    using TexturePtr = std::shared_ptr<const sf::Texture>;
+
+    static constexpr const std::size_t k_default_byte_budget = 64*1024*1024;
+
+    /** @returns the process wide cache, which ImageWidget uses */
+    static TextureCache & instance();
+
+    /** @returns estimated video memory used by a texture (assuming RGBA) */
+    static std::size_t estimate_bytes_of(const sf::Texture &);
+
+    explicit TextureCache(std::size_t byte_budget = k_default_byte_budget):
+        m_byte_budget(byte_budget)
+    {}
+
+    TextureCache(const TextureCache &) = delete;
+
+    TextureCache & operator = (const TextureCache &) = delete;
+
+    /** @returns the cached texture for a file, loading it if needed, or a
+     *           null pointer if the file cannot be loaded
+     */
+    TexturePtr load(const std::string & filename);
+
+    /** @returns the cached texture for a file, or a null pointer if it is
+     *           not cached (nothing is loaded)
+     */
+    TexturePtr find(const std::string & filename);
+
+    /** Adds an already loaded texture for a file (e.g. one uploaded by the
+     *  image loader).
+     *  @returns the texture now cached for that file, which is the existing
+     *           one if another was cached first
+     */
+    TexturePtr insert(const std::string & filename, TexturePtr);
+
+    void set_byte_budget(std::size_t);
+
+    std::size_t byte_budget() const noexcept { return m_byte_budget; }
+
+    /** @returns estimated video memory used by all cached textures */
+    std::size_t bytes_used() const noexcept { return m_bytes_used; }
+
+    std::size_t entry_count() const noexcept { return m_entries.size(); }
+
+    /** Evicts every texture held only by the cache, regardless of budget. */
+    void evict_unused();
+
+    /** Forgets every texture, those still in use live on with their users. */
+    void clear();
+
+private:
+    struct Entry {
+        std::string filename;
+        TexturePtr texture;
+        std::size_t bytes = 0;
+    };
+    using EntryList = std::list<Entry>;
+
+    TexturePtr add_entry(const std::string & filename, TexturePtr);
+
+    void mark_used(EntryList::iterator);
+
+    void evict_down_to(std::size_t byte_limit);
+
+    // most recently used first
+    EntryList m_entries;
+    std::unordered_map<std::string, EntryList::iterator> m_lookup;
+    std::size_t m_bytes_used = 0;
+    std::size_t m_byte_budget;
+};
+
+} // end of ksg namespace
@@ -34,6 +34,7 @@ namespace sf {
 
 namespace ksg {
 
+class DrawBatch;
 class FocusWidget;
 class Widget;
 
@@ -92,6 +93,14 @@ public:
      */
     virtual void issue_auto_resize();
 
+    /** @brief Called by frame to draw this widget, adding as much of its
+     *         geometry to the frame's batch as it can.
+     *  @note The default behavior is to draw the widget unbatched, which
+     *        flushes the batch beforehand.
+     *  @see DrawBatch
+     */
+    virtual void draw_to_batch(DrawBatch &) const;
+
     template <typename Func>
     void iterate_children_f(Func &&);
 
@@ -103,14 +112,33 @@ public:
 
     void iterate_children(ChildWidgetIterator &);
     void iterate_children(ChildWidgetIterator &) const;
-    void set_visible(bool v) { m_visible = v; }
+    void set_visible(bool v) {
+        if (v != m_visible) request_redraw();
+        m_visible = v;
+    }
 
     bool is_visible() const { return m_visible; }
+
+    /** Checks if this widget is requesting to be redrawn, and then turns the
+     *  request off.
+     *  @note this is const so that it may be checked while drawing
+     *  @return true if this widget's appearance has changed since the last
+     *          check
+     */
+    bool reset_redraw_request() const;
+
 protected:
+    /** A widget should request a redraw whenever its appearance changes (for
+     *  instance: on hover, text edits, or style/geometry changes). Frames
+     *  that cache their rendering respond to these requests when drawn.
+     */
+    void request_redraw() { m_redraw_requested = true; }
+
     virtual void iterate_children_(ChildWidgetIterator &);
     virtual void iterate_const_children_(ChildWidgetIterator &) const;
 private:
     bool m_visible;
+    mutable bool m_redraw_requested = true;
 };
 
 template <typename Func>
@@ -0,0 +1,156 @@
+/****************************************************************************
+
+    File: WidgetTimings.hpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <map>
+#include <unordered_map>
+
+namespace ksg {
+
+class Widget;
+
+/** @brief Collects call counts and cumulative time spent in widget
+ *         operations, per widget instance and per widget type.
+ *
+ *  Timing is opt-in, twice over:
+ *  - it must be compiled in by defining MACRO_KSG_WIDGET_TIMING, otherwise
+ *    all timers are empty objects and cost nothing
+ *  - it must then be turned on at runtime with set_enabled(true), otherwise
+ *    each timer costs a single branch
+ *
+ *  Times are inclusive, a frame's time includes its children's times.
+ *  Calls are timed where frames make them, so the root widget itself is not
+ *  timed, only everything it contains (and its finalize_widgets).
+ */
+class WidgetTimings final {
+public:
+    enum Operation {
+        k_process_event,
+        k_set_style,
+        k_issue_auto_resize,
+        k_finalize_widgets,
+        k_draw,
+        k_operation_count
+    };
+
+    struct Counter {
+        std::size_t calls = 0;
+        std::chrono::nanoseconds time { 0 };
+    };
+
+    using CounterArray = std::array<Counter, k_operation_count>;
+
+    struct InstanceRecord {
+        std::string type_name;
+        CounterArray counters;
+    };
+
+    using InstanceMap = std::unordered_map<const Widget *, InstanceRecord>;
+    using TypeMap     = std::map<std::string, CounterArray>;
+
+    static constexpr const bool k_compiled_in =
+#   ifdef MACRO_KSG_WIDGET_TIMING
+        true;
+#   else
+        false;
+#   endif
+
+    /** @returns the process wide collection, which all timers record into */
+    static WidgetTimings & instance();
+
+    static void set_enabled(bool b) { s_enabled = k_compiled_in && b; }
+
+    static bool is_enabled() { return s_enabled; }
+
+    static const char * operation_name(Operation);
+
+    void record(const Widget &, Operation, std::chrono::nanoseconds);
+
+    /** Clears all collected records. */
+    void reset();
+
+    /** @note widget addresses are only keys, widgets recorded may no longer
+     *        exist
+     */
+    const InstanceMap & per_instance() const noexcept { return m_instances; }
+
+    /** @returns counters summed over all instances of each type */
+    TypeMap per_type() const;
+
+    /** Writes a human readable table, per type then per instance. */
+    void dump_text(std::ostream &) const;
+
+    /** Writes an object with "types" and "instances" members. */
+    void dump_json(std::ostream &) const;
+
+private:
+    static bool s_enabled;
+
+    InstanceMap m_instances;
+};
+
+namespace detail {
+
+#ifdef MACRO_KSG_WIDGET_TIMING
+
+/** Times one widget operation, from construction to destruction. */
+class ScopedWidgetTimer final {
+public:
+    using Operation = WidgetTimings::Operation;
+    using Clock     = std::chrono::steady_clock;
+
+    ScopedWidgetTimer(const Widget & widget, Operation op):
+        m_widget(WidgetTimings::is_enabled() ? &widget : nullptr),
+        m_op(op)
+    { if (m_widget) m_start = Clock::now(); }
+
+    ScopedWidgetTimer(const ScopedWidgetTimer &) = delete;
+
+    ScopedWidgetTimer & operator = (const ScopedWidgetTimer &) = delete;
+
+    ~ScopedWidgetTimer() {
+        if (!m_widget) return;
+        WidgetTimings::instance().record(*m_widget, m_op, Clock::now() - m_start);
+    }
+
+private:
+    const Widget * m_widget;
+    Operation m_op;
+    Clock::time_point m_start;
+};
+
+#else
+
+class ScopedWidgetTimer final {
+public:
+    ScopedWidgetTimer(const Widget &, WidgetTimings::Operation) {}
+};
+
+#endif
+
+} // end of detail namespace
+
+} // end of ksg namespace
@@ -43,6 +43,20 @@ SOURCES += \
     ../src/TextButton.cpp    \
     ../src/Frame.cpp         \
     ../src/SelectionMenu.cpp \
+    ../src/EventQueue.cpp    \
+    ../src/EventRecorder.cpp \
+    ../src/AcceleratorTable.cpp \
+    ../src/WidgetTimings.cpp \
+    ../src/DrawBatch.cpp     \
+    ../src/RenderStats.cpp   \
+    ../src/ImageAtlas.cpp    \
+    ../src/ImageLoader.cpp   \
+    ../src/TextureCache.cpp  \
+    ../src/GlyphAtlas.cpp    \
+    ../src/BitmapFont.cpp    \
+    ../src/GlyphSource.cpp   \
+    ../src/TextLayoutCache.cpp \
+    ../src/ScrollView.cpp    \
     ../demos/textarea-tests.cpp
 
 HEADERS += \
@@ -68,7 +82,21 @@ HEADERS += \
     ../inc/ksg/FrameBorder.hpp    \
     ../inc/ksg/EditableText.hpp   \
     ../inc/ksg/TextArea.hpp       \
-    ../inc/ksg/SelectionMenu.hpp
+    ../inc/ksg/SelectionMenu.hpp  \
+    ../inc/ksg/EventQueue.hpp     \
+    ../inc/ksg/EventRecorder.hpp  \
+    ../inc/ksg/AcceleratorTable.hpp \
+    ../inc/ksg/WidgetTimings.hpp  \
+    ../inc/ksg/DrawBatch.hpp      \
+    ../inc/ksg/RenderStats.hpp    \
+    ../inc/ksg/ImageAtlas.hpp     \
+    ../inc/ksg/ImageLoader.hpp    \
+    ../inc/ksg/TextureCache.hpp   \
+    ../inc/ksg/GlyphAtlas.hpp     \
+    ../inc/ksg/BitmapFont.hpp     \
+    ../inc/ksg/GlyphSource.hpp    \
+    ../inc/ksg/TextLayoutCache.hpp \
+    ../inc/ksg/ScrollView.hpp
 
 INCLUDEPATH += \
     ../inc           \
@@ -43,7 +43,21 @@ SOURCES += \
     ../src/Text.cpp          \
     ../src/Widget.cpp        \
     ../src/EditableText.cpp  \
-    ../src/FocusWidget.cpp
+    ../src/FocusWidget.cpp   \
+    ../src/EventQueue.cpp    \
+    ../src/EventRecorder.cpp \
+    ../src/AcceleratorTable.cpp \
+    ../src/WidgetTimings.cpp \
+    ../src/DrawBatch.cpp     \
+    ../src/RenderStats.cpp   \
+    ../src/ImageAtlas.cpp    \
+    ../src/ImageLoader.cpp   \
+    ../src/TextureCache.cpp  \
+    ../src/GlyphAtlas.cpp    \
+    ../src/BitmapFont.cpp    \
+    ../src/GlyphSource.cpp   \
+    ../src/TextLayoutCache.cpp \
+    ../src/ScrollView.cpp
 
 HEADERS += \
     \ # private headers
@@ -67,7 +81,21 @@ HEADERS += \
     ../inc/ksg/Visitor.hpp        \
     ../inc/ksg/ForwardWidgets.hpp \
     ../inc/ksg/EditableText.hpp   \
-    ../inc/ksg/FocusWidget.hpp
+    ../inc/ksg/FocusWidget.hpp    \
+    ../inc/ksg/EventQueue.hpp     \
+    ../inc/ksg/EventRecorder.hpp  \
+    ../inc/ksg/AcceleratorTable.hpp \
+    ../inc/ksg/WidgetTimings.hpp  \
+    ../inc/ksg/DrawBatch.hpp      \
+    ../inc/ksg/RenderStats.hpp    \
+    ../inc/ksg/ImageAtlas.hpp     \
+    ../inc/ksg/ImageLoader.hpp    \
+    ../inc/ksg/TextureCache.hpp   \
+    ../inc/ksg/GlyphAtlas.hpp     \
+    ../inc/ksg/BitmapFont.hpp     \
+    ../inc/ksg/GlyphSource.hpp    \
+    ../inc/ksg/TextLayoutCache.hpp \
+    ../inc/ksg/ScrollView.hpp
 
 INCLUDEPATH += \
     ../inc           \
@@ -0,0 +1,164 @@
+/****************************************************************************
+
+    File: AcceleratorTable.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/AcceleratorTable.hpp>
+
+#include <SFML/Window/Event.hpp>
+
+#include <stdexcept>
+
+#include <cassert>
+
+namespace {
+
+// power of two, so that slots can be found by masking
+constexpr const std::size_t k_initial_capacity = 16;
+
+std::uint8_t modifiers_of(const sf::Event::KeyEvent &);
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+/* private static */ constexpr const std::uint32_t AcceleratorTable::k_empty_slot;
+
+void AcceleratorTable::insert
+    (Key key, std::uint8_t modifiers, Callback && callback)
+{
+    if (!callback) {
+        throw std::invalid_argument(
+            "AcceleratorTable::insert: callback must refer to a callable "
+            "object.");
+    }
+    if (key == sf::Keyboard::Unknown) {
+        throw std::invalid_argument(
+            "AcceleratorTable::insert: cannot use an unknown key for an "
+            "accelerator.");
+    }
+    // keep the load factor at or below one half, keeping probes short
+    if ((m_size + 1)*2 > m_entries.size()) grow();
+
+    auto combo = to_packed_combo(key, modifiers);
+    auto slot  = find_slot(combo);
+    if (m_entries[slot].combo == k_empty_slot) ++m_size;
+    m_entries[slot].combo    = combo;
+    m_entries[slot].callback = std::move(callback);
+}
+
+bool AcceleratorTable::erase(Key key, std::uint8_t modifiers) {
+    if (m_entries.empty() || key == sf::Keyboard::Unknown) return false;
+    auto slot = find_slot(to_packed_combo(key, modifiers));
+    if (m_entries[slot].combo == k_empty_slot) return false;
+
+    // backward shift deletion, so that no tombstones are ever needed
+    const auto mask = m_entries.size() - 1;
+    auto hole = slot;
+    for (auto next = (hole + 1) & mask; m_entries[next].combo != k_empty_slot;
+         next = (next + 1) & mask)
+    {
+        auto home = home_slot_of(m_entries[next].combo);
+        // move the entry back, only if the hole lies within its probe run
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            m_entries[hole] = std::move(m_entries[next]);
+            hole = next;
+        }
+    }
+    m_entries[hole].combo = k_empty_slot;
+    m_entries[hole].callback = nullptr;
+    --m_size;
+    return true;
+}
+
+void AcceleratorTable::clear() {
+    m_entries.clear();
+    m_size = 0;
+}
+
+bool AcceleratorTable::process_event(const sf::Event & event) const {
+    if (event.type != sf::Event::KeyPressed || m_size == 0) return false;
+    // SFML reports many real keys (e.g. media keys) as unknown, none of
+    // which can have an accelerator
+    if (event.key.code == sf::Keyboard::Unknown) return false;
+    const auto & entry = m_entries[
+        find_slot(to_packed_combo(event.key.code, modifiers_of(event.key)))];
+    if (entry.combo == k_empty_slot) return false;
+    // called from a copy, as the callback may add or erase accelerators,
+    // which could move or destroy the entry it lives in
+    auto callback = entry.callback;
+    callback();
+    return true;
+}
+
+void AcceleratorTable::swap(AcceleratorTable & rhs) {
+    m_entries.swap(rhs.m_entries);
+    std::swap(m_size, rhs.m_size);
+}
+
+/* private static */ std::uint32_t AcceleratorTable::to_packed_combo
+    (Key key, std::uint8_t modifiers) noexcept
+{
+    assert(key != sf::Keyboard::Unknown);
+    // offset by one, zero is reserved for empty slots
+    return ((std::uint32_t(key) + 1) << 4) | (modifiers & 0xF);
+}
+
+/* private */ std::size_t AcceleratorTable::home_slot_of
+    (std::uint32_t combo) const noexcept
+{
+    // fibonacci hashing, spreads the (very dense) key codes across the table
+    assert(!m_entries.empty());
+    return std::size_t((combo * 2654435769u) >> 16) & (m_entries.size() - 1);
+}
+
+/* private */ std::size_t AcceleratorTable::find_slot
+    (std::uint32_t combo) const noexcept
+{
+    const auto mask = m_entries.size() - 1;
+    auto slot = home_slot_of(combo);
+    while (m_entries[slot].combo != k_empty_slot && m_entries[slot].combo != combo)
+        { slot = (slot + 1) & mask; }
+    return slot;
+}
+
+/* private */ void AcceleratorTable::grow() {
+    std::vector<Entry> old_entries;
+    old_entries.swap(m_entries);
+    m_entries.resize(old_entries.empty() ? k_initial_capacity : old_entries.size()*2);
+    for (auto & entry : old_entries) {
+        if (entry.combo == k_empty_slot) continue;
+        auto & new_entry = m_entries[find_slot(entry.combo)];
+        new_entry = std::move(entry);
+    }
+}
+
+} // end of ksg namespace
+
+namespace {
+
+std::uint8_t modifiers_of(const sf::Event::KeyEvent & key) {
+    using Table = ksg::AcceleratorTable;
+    return std::uint8_t(  (key.alt     ? Table::k_alt     : 0)
+                        | (key.control ? Table::k_control : 0)
+                        | (key.shift   ? Table::k_shift   : 0)
+                        | (key.system  ? Table::k_system  : 0));
+}
+
+} // end of <anonymous> namespace
@@ -20,6 +20,7 @@
 *****************************************************************************/
 
 #include <ksg/ArrowButton.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -40,6 +41,12 @@ void ArrowButton::process_event(const sf::Event & evnt) {
     Button::process_event(evnt);
 }
 
+void ArrowButton::draw_to_batch(DrawBatch & batch) const {
+    Button::draw_to_batch(batch);
+    if (m_dir == Direction::k_none) return;
+    batch.add_triangle(m_draw_tri);
+}
+
 /* private */ void ArrowButton::draw
     (sf::RenderTarget & target, sf::RenderStates) const
 {
@@ -83,6 +90,7 @@ void ArrowButton::process_event(const sf::Event & evnt) {
         deselect();
         break;
     }
+    request_redraw();
 }
 
 } // end of ksg namespace
@@ -0,0 +1,279 @@
+/****************************************************************************
+
+    File: BitmapFont.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/BitmapFont.hpp>
+#include <ksg/GlyphAtlas.hpp>
+
+#include <fstream>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+
+#include <cassert>
+
+namespace {
+
+using Attribute = std::pair<std::string, std::string>;
+
+// splits a metrics line into its tag (e.g. "char") and its key=value
+// attributes, values may be quoted
+std::string parse_line(const std::string & line, std::vector<Attribute> & attributes);
+
+// returns false if the key is not present
+bool find_int(const std::vector<Attribute> &, const char * key, int & out);
+
+std::string find_string(const std::vector<Attribute> &, const char * key);
+
+std::string directory_of(const std::string & filename);
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+bool BitmapFont::load_from_file(const std::string & filename) {
+    // loaded apart, so that this font is left as it was on any failure
+    BitmapFont loaded;
+    std::ifstream fin(filename);
+    if (!fin || !loaded.load_metrics(fin)) return false;
+
+    const auto directory = directory_of(filename);
+    for (const auto & page_file : loaded.m_page_files) {
+        loaded.m_pages.push_back(std::make_unique<sf::Texture>());
+        if (!loaded.m_pages.back()->loadFromFile(directory + page_file))
+            return false;
+    }
+    swap(loaded);
+    return true;
+}
+
+bool BitmapFont::load_metrics(std::istream & in) {
+    std::vector<CharacterRecord> glyphs;
+    std::vector<Kerning> kernings;
+    std::vector<std::string> page_files;
+    int baked_size = 0, line_spacing = 0, baseline = 0;
+
+    std::vector<Attribute> attributes;
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto tag = parse_line(line, attributes);
+        if (tag == "info") {
+            if (!find_int(attributes, "size", baked_size)) return false;
+            // negative sizes ask for matching character heights instead of
+            // cell heights, the magnitude is what's wanted either way
+            baked_size = std::abs(baked_size);
+        } else if (tag == "common") {
+            if (!find_int(attributes, "lineHeight", line_spacing) ||
+                !find_int(attributes, "base"      , baseline    ))
+            { return false; }
+        } else if (tag == "page") {
+            int id = 0;
+            if (!find_int(attributes, "id", id) || id < 0) return false;
+            if (page_files.size() <= std::size_t(id))
+                page_files.resize(std::size_t(id) + 1);
+            page_files[std::size_t(id)] = find_string(attributes, "file");
+        } else if (tag == "char") {
+            int id = 0, x = 0, y = 0, w = 0, h = 0, xoff = 0, yoff = 0,
+                advance = 0, page = 0;
+            if (!find_int(attributes, "id"      , id     ) ||
+                !find_int(attributes, "x"       , x      ) ||
+                !find_int(attributes, "y"       , y      ) ||
+                !find_int(attributes, "width"   , w      ) ||
+                !find_int(attributes, "height"  , h      ) ||
+                !find_int(attributes, "xoffset" , xoff   ) ||
+                !find_int(attributes, "yoffset" , yoff   ) ||
+                !find_int(attributes, "xadvance", advance) ||
+                !find_int(attributes, "page"    , page   ) ||
+                id < 0 || page < 0)
+            { return false; }
+            CharacterRecord rec;
+            rec.code_point          = char32_t(id);
+            rec.page                = std::size_t(page);
+            rec.glyph.advance       = float(advance);
+            // relative to the baseline, as SFML's glyphs are, which is only
+            // known once "common" is read, so adjusted later
+            rec.glyph.bounds        = sf::FloatRect(float(xoff), float(yoff),
+                                                    float(w), float(h));
+            rec.glyph.textureRect   = sf::IntRect(x, y, w, h);
+            glyphs.push_back(rec);
+        } else if (tag == "kerning") {
+            int first = 0, second = 0, amount = 0;
+            if (!find_int(attributes, "first" , first ) ||
+                !find_int(attributes, "second", second) ||
+                !find_int(attributes, "amount", amount))
+            { return false; }
+            if (amount == 0) continue;
+            Kerning kerning;
+            kerning.key    = make_kerning_key(char32_t(first), char32_t(second));
+            kerning.amount = float(amount);
+            kernings.push_back(kerning);
+        }
+    }
+    if (baked_size == 0 || line_spacing == 0 || glyphs.empty()) return false;
+    for (const auto & rec : glyphs) {
+        if (rec.page >= page_files.size()) return false;
+    }
+
+    for (auto & rec : glyphs) rec.glyph.bounds.top -= float(baseline);
+    std::sort(glyphs.begin(), glyphs.end(),
+        [](const CharacterRecord & a, const CharacterRecord & b)
+        { return a.code_point < b.code_point; });
+    std::sort(kernings.begin(), kernings.end(),
+        [](const Kerning & a, const Kerning & b) { return a.key < b.key; });
+
+    m_glyphs.swap(glyphs);
+    m_kernings.swap(kernings);
+    m_page_files.swap(page_files);
+    m_pages.clear();
+    m_baked_size   = unsigned(baked_size);
+    m_line_spacing = float(line_spacing);
+    m_baseline     = float(baseline);
+    m_fixed_advance = find_fixed_advance();
+    return true;
+}
+
+const BitmapFont::CharacterRecord & BitmapFont::glyph(char32_t code_point) const {
+    static const CharacterRecord k_empty_glyph;
+    if (const auto * rec = find_glyph(code_point)) return *rec;
+    if (const auto * rec = find_glyph(U'?'     )) return *rec;
+    return k_empty_glyph;
+}
+
+bool BitmapFont::has_glyph(char32_t code_point) const
+    { return find_glyph(code_point); }
+
+float BitmapFont::kerning(char32_t first, char32_t second) const {
+    if (m_kernings.empty()) return 0.f;
+    const auto key = make_kerning_key(first, second);
+    auto itr = std::lower_bound(m_kernings.begin(), m_kernings.end(), key,
+        [](const Kerning & kerning, KerningKey key) { return kerning.key < key; });
+    if (itr == m_kernings.end() || itr->key != key) return 0.f;
+    return itr->amount;
+}
+
+const sf::Texture * BitmapFont::page_texture(std::size_t page) const {
+    if (page >= m_pages.size()) return nullptr;
+    return m_pages[page].get();
+}
+
+/* private */ void BitmapFont::swap(BitmapFont & rhs) noexcept {
+    m_glyphs       .swap(rhs.m_glyphs      );
+    m_kernings     .swap(rhs.m_kernings    );
+    m_page_files   .swap(rhs.m_page_files  );
+    m_pages        .swap(rhs.m_pages       );
+    std::swap(m_baked_size   , rhs.m_baked_size   );
+    std::swap(m_line_spacing , rhs.m_line_spacing );
+    std::swap(m_baseline     , rhs.m_baseline     );
+    std::swap(m_fixed_advance, rhs.m_fixed_advance);
+}
+
+/* private */ const BitmapFont::CharacterRecord * BitmapFont::find_glyph
+    (char32_t code_point) const
+{
+    auto itr = std::lower_bound(m_glyphs.begin(), m_glyphs.end(), code_point,
+        [](const CharacterRecord & rec, char32_t c) { return rec.code_point < c; });
+    if (itr == m_glyphs.end() || itr->code_point != code_point) return nullptr;
+    return &*itr;
+}
+
+/* private */ float BitmapFont::find_fixed_advance() const {
+    using Atlas = GlyphAtlas;
+    // missing glyphs are drawn as '?', so they are checked like any other
+    float advance = glyph(U' ').glyph.advance;
+    if (advance == 0.f) return 0.f;
+    for (char32_t c = U' '; Atlas::is_metrics_sample(c); ++c) {
+        if (glyph(c).glyph.advance != advance) return 0.f;
+    }
+    for (const auto & kerning : m_kernings) {
+        if (   kerning.amount != 0.f
+            && Atlas::is_metrics_sample(char32_t(kerning.key >> 32))
+            && Atlas::is_metrics_sample(char32_t(kerning.key & 0xFFFFFFFFu)))
+        { return 0.f; }
+    }
+    return advance;
+}
+
+} // end of ksg namespace
+
+namespace {
+
+std::string parse_line(const std::string & line, std::vector<Attribute> & attributes) {
+    attributes.clear();
+    std::size_t pos = 0;
+    auto skip_spaces = [&]() {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+            ++pos;
+    };
+    auto read_until = [&](auto is_end) {
+        auto beg = pos;
+        while (pos < line.size() && !is_end(line[pos])) ++pos;
+        return line.substr(beg, pos - beg);
+    };
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+
+    skip_spaces();
+    auto tag = read_until(is_space);
+    while (true) {
+        skip_spaces();
+        if (pos >= line.size()) break;
+        auto key = read_until([&](char c) { return c == '=' || is_space(c); });
+        std::string value;
+        if (pos < line.size() && line[pos] == '=') {
+            ++pos;
+            if (pos < line.size() && line[pos] == '"') {
+                ++pos;
+                value = read_until([](char c) { return c == '"'; });
+                ++pos;
+            } else {
+                value = read_until(is_space);
+            }
+        }
+        attributes.emplace_back(std::move(key), std::move(value));
+    }
+    return tag;
+}
+
+bool find_int(const std::vector<Attribute> & attributes, const char * key, int & out) {
+    for (const auto & attr : attributes) {
+        if (attr.first != key) continue;
+        // values such as "padding=0,0,0,0" are never asked for
+        char * end = nullptr;
+        long value = std::strtol(attr.second.c_str(), &end, 10);
+        if (end == attr.second.c_str()) return false;
+        out = int(value);
+        return true;
+    }
+    return false;
+}
+
+std::string find_string(const std::vector<Attribute> & attributes, const char * key) {
+    for (const auto & attr : attributes) {
+        if (attr.first == key) return attr.second;
+    }
+    return std::string();
+}
+
+std::string directory_of(const std::string & filename) {
+    auto slash = filename.find_last_of("/\\");
+    if (slash == std::string::npos) return std::string();
+    return filename.substr(0, slash + 1);
+}
+
+} // end of <anonymous> namespace
@@ -21,6 +21,7 @@
 
 #include <ksg/Button.hpp>
 #include <ksg/Frame.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -95,6 +96,7 @@ void Button::set_style(const StyleMap & smap) {
 
     m_outer.set_color(m_reg.back);
     m_inner.set_color(m_reg.front);
+    request_redraw();
 }
 
 void Button::set_press_event(BlankFunctor && func) {
@@ -120,6 +122,11 @@ void Button::set_size(float width_, float height_) {
     on_size_changed(old_width, old_height);
 }
 
+void Button::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_outer);
+    batch.add_rectangle(m_inner);
+}
+
 /* protected */ Button::Button() {}
 
 /* protected */ void Button::draw
@@ -141,9 +148,12 @@ void Button::set_size(float width_, float height_) {
     m_outer.set_size(width_, height_);
     m_inner.set_size(std::max(width_  - m_padding*2.f, 0.f),
                      std::max(height_ - m_padding*2.f, 0.f));
+    request_redraw();
 }
 
 /* protected */ void Button::deselect() {
+    // mouse moves deselect repeatedly, only a change in state is a redraw
+    if (m_is_highlighted) request_redraw();
     m_is_highlighted = false;
     m_inner.set_color(m_reg.front);
     if (has_focus()) {
@@ -154,6 +164,7 @@ void Button::set_size(float width_, float height_) {
 }
 
 /* protected */ void Button::highlight() {
+    if (!m_is_highlighted) request_redraw();
     m_is_highlighted = true;
     m_inner.set_color(m_hover.front);
     if (has_focus()) {
@@ -173,10 +184,12 @@ void Button::set_size(float width_, float height_) {
 
 /* private */ void Button::notify_focus_gained() {
     m_outer.set_color(m_hover.front);
+    request_redraw();
 }
 
 /* private */ void Button::notify_focus_lost() {
     m_outer.set_color(m_reg.back);
+    request_redraw();
 }
 
 } // end of ksg namespace
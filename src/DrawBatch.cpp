@@ -0,0 +1,210 @@
+/****************************************************************************
+
+    File: DrawBatch.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/DrawBatch.hpp>
+#include <ksg/DrawTriangle.hpp>
+#include <ksg/RenderStats.hpp>
+
+#include <common/DrawRectangle.hpp>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+
+#include <cassert>
+
+namespace ksg {
+
+DrawBatch::DrawBatch(sf::RenderTarget & target, const sf::RenderStates & states):
+    m_target(&target),
+    m_states(states)
+{}
+
+DrawBatch::~DrawBatch() {
+    flush();
+    if (!m_clips.empty()) m_target->setView(m_clips.front().previous_view);
+}
+
+void DrawBatch::add_rectangle(const DrawRectangle & drect) {
+    if (drect.width() == 0.f || drect.height() == 0.f) return;
+    const auto color = drect.color();
+    const float x = drect.x(), y = drect.y();
+    const sf::Vertex quad[] = {
+        sf::Vertex(VectorF(x                , y                 ), color),
+        sf::Vertex(VectorF(x + drect.width(), y                 ), color),
+        sf::Vertex(VectorF(x + drect.width(), y + drect.height()), color),
+        sf::Vertex(VectorF(x                , y + drect.height()), color)
+    };
+    add_quad(quad, nullptr);
+}
+
+void DrawBatch::add_triangle(const DrawTriangle & tri) {
+    const auto color = tri.color();
+    const sf::Vertex verticies[] = {
+        sf::Vertex(tri.point_a(), color),
+        sf::Vertex(tri.point_b(), color),
+        sf::Vertex(tri.point_c(), color)
+    };
+    add_triangles(verticies, 3, nullptr);
+}
+
+void DrawBatch::add_quad
+    (const sf::Vertex * quad, const sf::Texture * texture,
+     const sf::Shader * shader)
+{
+    assert(quad);
+    if (m_clipped_out) return;
+    auto & bucket = bucket_for(texture, shader);
+    // two triangles: top-left, top-right, bottom-right
+    //                bottom-right, bottom-left, top-left
+    for (int i : { 0, 1, 2, 2, 3, 0 }) {
+        bucket.push_back(quad[i]);
+    }
+    if (m_render_stats) m_render_stats->record_added_vertices(6);
+}
+
+void DrawBatch::add_triangles
+    (const sf::Vertex * verticies, std::size_t count,
+     const sf::Texture * texture, const sf::Shader * shader)
+{
+    if (count % 3 != 0) {
+        throw std::invalid_argument("DrawBatch::add_triangles: vertex count "
+                                    "must be a multiple of three.");
+    }
+    if (m_clipped_out) return;
+    auto & bucket = bucket_for(texture, shader);
+    bucket.insert(bucket.end(), verticies, verticies + count);
+    if (m_render_stats) m_render_stats->record_added_vertices(count);
+}
+
+void DrawBatch::draw_unbatched(const sf::Drawable & drawable) {
+    flush();
+    if (m_clipped_out) return;
+    m_target->draw(drawable, m_states);
+    if (m_render_stats) m_render_stats->record_unbatched_draw();
+}
+
+void DrawBatch::flush() {
+    for (auto & bucket : m_buckets) {
+        if (bucket.vertices.empty()) continue;
+        auto states = m_states;
+        states.texture = bucket.texture;
+        if (bucket.shader) states.shader = bucket.shader;
+        m_target->draw(bucket.vertices.data(), bucket.vertices.size(),
+                       sf::Triangles, states);
+        if (m_render_stats) {
+            m_render_stats->record_draw(sf::Triangles, bucket.vertices.size(),
+                                        bucket.texture);
+        }
+        bucket.vertices.clear();
+    }
+}
+
+void DrawBatch::push_clip(const sf::FloatRect & area) {
+    flush();
+    Clip clip;
+    clip.previous_view          = m_target->getView();
+    clip.previously_clipped_out = m_clipped_out;
+    m_clips.push_back(clip);
+    if (m_clipped_out) return;
+
+    const auto & view = clip.previous_view;
+    const auto world_area = m_states.transform.transformRect(area);
+    auto a = m_target->mapCoordsToPixel(
+        VectorF(world_area.left, world_area.top), view);
+    auto b = m_target->mapCoordsToPixel(
+        VectorF(world_area.left + world_area.width,
+                world_area.top  + world_area.height), view);
+    // clips nest, so never draw outside of the present viewport
+    const auto bounds = m_target->getViewport(view);
+    int left   = std::max(std::min(a.x, b.x), bounds.left);
+    int top    = std::max(std::min(a.y, b.y), bounds.top );
+    int right  = std::min(std::max(a.x, b.x), bounds.left + bounds.width );
+    int bottom = std::min(std::max(a.y, b.y), bounds.top  + bounds.height);
+    if (right <= left || bottom <= top) {
+        m_clipped_out = true;
+        return;
+    }
+
+    // the new view shows exactly what the old one did in those pixels
+    auto world_a = m_target->mapPixelToCoords(sf::Vector2i(left , top   ), view);
+    auto world_b = m_target->mapPixelToCoords(sf::Vector2i(right, bottom), view);
+    sf::View clipped(sf::FloatRect(world_a, world_b - world_a));
+    const auto target_size = m_target->getSize();
+    clipped.setViewport(sf::FloatRect(
+        float(left)         / float(target_size.x),
+        float(top)          / float(target_size.y),
+        float(right - left) / float(target_size.x),
+        float(bottom - top) / float(target_size.y)));
+    m_target->setView(clipped);
+}
+
+void DrawBatch::pop_clip() {
+    if (m_clips.empty()) {
+        throw std::runtime_error("DrawBatch::pop_clip: there is no clip to "
+                                 "pop.");
+    }
+    flush();
+    m_target->setView(m_clips.back().previous_view);
+    m_clipped_out = m_clips.back().previously_clipped_out;
+    m_clips.pop_back();
+}
+
+void DrawBatch::push_transform(const sf::Transform & transform) {
+    flush();
+    m_transforms.push_back(m_states.transform);
+    m_states.transform.combine(transform);
+}
+
+void DrawBatch::pop_transform() {
+    if (m_transforms.empty()) {
+        throw std::runtime_error("DrawBatch::pop_transform: there is no "
+                                 "transform to pop.");
+    }
+    flush();
+    m_states.transform = m_transforms.back();
+    m_transforms.pop_back();
+}
+
+sf::FloatRect DrawBatch::visible_area() const {
+    // the inverse view transform maps normalized device coordinates back
+    // into the world, this also covers rotated views
+    const auto world_area = m_target->getView().getInverseTransform().
+        transformRect(sf::FloatRect(-1.f, -1.f, 2.f, 2.f));
+    return m_states.transform.getInverse().transformRect(world_area);
+}
+
+/* private */ std::vector<sf::Vertex> & DrawBatch::bucket_for
+    (const sf::Texture * texture, const sf::Shader * shader)
+{
+    // there are seldom more than a few textures in use at once
+    for (auto & bucket : m_buckets) {
+        if (bucket.texture == texture && bucket.shader == shader)
+            return bucket.vertices;
+    }
+    m_buckets.emplace_back();
+    m_buckets.back().texture = texture;
+    m_buckets.back().shader  = shader;
+    return m_buckets.back().vertices;
+}
+
+} // end of ksg namespace
@@ -20,164 +20,69 @@
 *****************************************************************************/
 
 #include <ksg/DrawCharacter.hpp>
+#include <ksg/DrawBatch.hpp>
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
 
-#include <common/Util.hpp>
-
-#include <cassert>
+#include <algorithm>
 
 namespace ksg {
 
-namespace {
-
-using VectorF = sf::Vector2f;
-
-constexpr const int k_top_left_index     = 0;
-constexpr const int k_top_right_index    = 1;
-constexpr const int k_bottom_right_index = 2;
-constexpr const int k_bottom_left_index  = 3;
-
-} // end of <anonymous> namespace
-
 namespace detail {
 
-DrawableCharacter::DrawableCharacter(VectorF loc, const sf::Glyph & glyph, sf::Color clr):
-    DrawableCharacter(glyph, clr)
-{
-    set_location(loc.x, loc.y);
-}
-
-DrawableCharacter::DrawableCharacter(const sf::Glyph & glyph, sf::Color clr) {
-    using Vector2f = sf::Vector2f;
-
-    float left   = glyph.bounds.left;
-    float top    = glyph.bounds.top;
-    float right  = glyph.bounds.left + glyph.bounds.width;
-    float bottom = glyph.bounds.top  + glyph.bounds.height;
+/* static */ constexpr const std::size_t GlyphRecord::k_max_table_size;
 
-    // abbr: texture, left/top/right/bottom
-    float trL = float(glyph.textureRect.left);
-    float trT = float(glyph.textureRect.top);
-    float trR = float(glyph.textureRect.left + glyph.textureRect.width);
-    float trB = float(glyph.textureRect.top  + glyph.textureRect.height);
-
-    // Add a quad for the current character
-    m_verticies[k_top_left_index    ] = sf::Vertex(Vector2f(left , top   ), clr, Vector2f(trL, trT));
-    m_verticies[k_top_right_index   ] = sf::Vertex(Vector2f(right, top   ), clr, Vector2f(trR, trT));
-    m_verticies[k_bottom_right_index] = sf::Vertex(Vector2f(right, bottom), clr, Vector2f(trR, trB));
-    m_verticies[k_bottom_left_index ] = sf::Vertex(Vector2f(left , bottom), clr, Vector2f(trL, trB));
-
-    check_invarients();
-}
-
-void DrawableCharacter::set_color(sf::Color clr) {
-    for (sf::Vertex & v : m_verticies)
-        v.color = clr;
-}
-
-sf::Color DrawableCharacter::color() const
-    { return m_verticies.front().color; }
-
-float DrawableCharacter::width() const {
-    return m_verticies[k_top_right_index].position.x -
-           m_verticies[k_top_left_index ].position.x;
-}
-
-float DrawableCharacter::height() const {
-    return m_verticies[k_bottom_left_index].position.y -
-           m_verticies[k_top_right_index  ].position.y;
-}
-
-void DrawableCharacter::cut_on_right(float cut_line) {
-    sf::Vertex & tr = m_verticies[k_top_right_index];
-    sf::Vertex & br = m_verticies[k_bottom_right_index];
-    const sf::Vertex & any_left = m_verticies[k_top_left_index];
-
-    // do not do a cut, if the line is far away from the character
-    if (cut_line > tr.position.x) return;
-
-    // if the cut line exceeds the draw character's bounds, reduce its width
-    // to zero
-    if (cut_line < any_left.position.x) {
-        tr.position.x = br.position.x = any_left.position.x;
-        check_invarients();
-        return;
-    }
-
-    float cut_ratio = (cut_line - any_left.position.x)/
-                      (br.position.x - any_left.position.x);
-    // need to find proportion of the char's texture to cut off
-    float tx_width = tr.texCoords.x - any_left.texCoords.x;
-    tr.position.x = br.position.x = cut_line;
-    tr.texCoords.x = br.texCoords.x = any_left.texCoords.x + tx_width*cut_ratio;
-    check_invarients();
-}
-
-void DrawableCharacter::cut_on_bottom(float cut_line) {
-    sf::Vertex & bl = m_verticies[k_bottom_left_index];
-    sf::Vertex & br = m_verticies[k_bottom_right_index];
-    const sf::Vertex & any_top = m_verticies[k_top_left_index];
-
-    // do not do a cut, if the line is far below the character
-    if (cut_line > bl.position.y) return;
-
-    // if the cut line exceeds the draw character's bounds, reduce its height
-    // to zero
-    if (cut_line < any_top.position.y) {
-        bl.position.y = br.position.y = any_top.position.y;
-        check_invarients();
-        return;
-    }
-
-    float cut_ratio = (cut_line - any_top.position.y)/
-                      (br.position.y - any_top.position.y);
-    float tx_height = bl.texCoords.y - any_top.texCoords.y;
-    br.position.y = bl.position.y = cut_line;
-    br.texCoords.y = bl.texCoords.y = any_top.texCoords.y + tx_height*cut_ratio;
-    check_invarients();
-}
-
-void DrawableCharacter::set_location(float x, float y) {
-    float w = width(), h = height();
-    for (sf::Vertex & v : m_verticies)
-        v.position = sf::Vector2f(x, y);
-    m_verticies[k_top_right_index   ].position.x += w;
-    m_verticies[k_bottom_left_index ].position.y += h;
-    m_verticies[k_bottom_right_index].position.y += h;
-    m_verticies[k_bottom_right_index].position.x += w;
-    check_invarients();
-}
-
-void DrawableCharacter::move(float x, float y) {
-    for (sf::Vertex & v : m_verticies)
-        v.position += sf::Vector2f(x, y);
-    check_invarients();
-}
-
-VectorF DrawableCharacter::location() const {
-    return m_verticies[k_top_left_index].position;
-}
-
-bool DrawableCharacter::whiped_out() const {
-    return magnitude(width()) < 1.f || magnitude(height()) < 1.f;
-}
-
-/* private final */ void DrawableCharacter::draw
-    (sf::RenderTarget & target, sf::RenderStates states) const
+void add_glyph_to_batch
+    (DrawBatch & batch, const GlyphRecord & record, const GlyphQuad & quad,
+     sf::Color color, sf::Vector2f offset, const sf::Shader * shader)
 {
-    const sf::Vertex & tl = m_verticies[k_top_left_index];
-    const sf::Vertex & br = m_verticies[k_bottom_right_index];
-    if (   magnitude(tl.position.x - br.position.x) < 0.5f
-        || magnitude(tl.position.y - br.position.y) < 0.5f)
-        return;
-    target.draw(&m_verticies[0], m_verticies.size(), sf::Quads, states);
+    using VectorF = sf::Vector2f;
+    const auto pos     = record.location + offset;
+    const auto & trect = quad.texture_rectangle;
+    const sf::Vertex verticies[] = {
+        sf::Vertex(pos                                , color,
+                   VectorF(trect.left              , trect.top               )),
+        sf::Vertex(pos + VectorF(quad.size.x, 0.f    ), color,
+                   VectorF(trect.left + trect.width, trect.top               )),
+        sf::Vertex(pos + quad.size                    , color,
+                   VectorF(trect.left + trect.width, trect.top + trect.height)),
+        sf::Vertex(pos + VectorF(0.f, quad.size.y    ), color,
+                   VectorF(trect.left              , trect.top + trect.height))
+    };
+    batch.add_quad(verticies, quad.texture, shader);
 }
 
-/* private */ void DrawableCharacter::check_invarients() const {
-    for (const auto & vtx : m_verticies) {
-        assert(is_real(vtx.position.x) && is_real(vtx.position.y));
-    }
+void add_clipped_glyph_to_batch
+    (DrawBatch & batch, const GlyphRecord & record, const GlyphQuad & quad,
+     sf::Color color, const sf::FloatRect & clip_area, sf::Vector2f offset,
+     const sf::Shader * shader)
+{
+    using VectorF = sf::Vector2f;
+    const auto & loc = record.location;
+    const float left   = std::max(loc.x, clip_area.left);
+    const float top    = std::max(loc.y, clip_area.top );
+    const float right  = std::min(loc.x + quad.size.x, clip_area.left + clip_area.width );
+    const float bottom = std::min(loc.y + quad.size.y, clip_area.top  + clip_area.height);
+    if (left >= right || top >= bottom) return;
+    if (   left == loc.x && right  == loc.x + quad.size.x
+        && top  == loc.y && bottom == loc.y + quad.size.y)
+    { return add_glyph_to_batch(batch, record, quad, color, offset, shader); }
+
+    // texture coordinates are trimmed in proportion to the quad
+    const auto & trect = quad.texture_rectangle;
+    const float tx_scale = quad.size.x == 0.f ? 0.f : trect.width  / quad.size.x;
+    const float ty_scale = quad.size.y == 0.f ? 0.f : trect.height / quad.size.y;
+    const float tleft   = trect.left + (left   - loc.x)*tx_scale;
+    const float ttop    = trect.top  + (top    - loc.y)*ty_scale;
+    const float tright  = trect.left + (right  - loc.x)*tx_scale;
+    const float tbottom = trect.top  + (bottom - loc.y)*ty_scale;
+    const sf::Vertex verticies[] = {
+        sf::Vertex(VectorF(left , top   ) + offset, color, VectorF(tleft , ttop   )),
+        sf::Vertex(VectorF(right, top   ) + offset, color, VectorF(tright, ttop   )),
+        sf::Vertex(VectorF(right, bottom) + offset, color, VectorF(tright, tbottom)),
+        sf::Vertex(VectorF(left , bottom) + offset, color, VectorF(tleft , tbottom))
+    };
+    batch.add_quad(verticies, quad.texture, shader);
 }
 
 } // end of detail namespace
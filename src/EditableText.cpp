@@ -23,6 +23,7 @@
 #include <ksg/Button.hpp>
 #include <ksg/Frame.hpp>
 #include <ksg/TextArea.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -94,13 +95,18 @@ void Ellipsis::set_location(float x, float y) {
     }
 }
 
+void Ellipsis::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_back);
+    for (const auto & tri : m_dots) {
+        batch.add_triangle(tri);
+    }
+}
+
 /* private */ void Ellipsis::draw
     (sf::RenderTarget & target, sf::RenderStates states) const
 {
-    target.draw(m_back, states);
-    for (const auto & tri : m_dots) {
-        target.draw(tri);
-    }
+    DrawBatch batch(target, states);
+    draw_to_batch(batch);
 }
 
 } // end of detail namespace
@@ -207,8 +213,10 @@ const UString & EditableText::text() const
 const UString & EditableText::string() const
     { return m_text.string(); }
 
-void EditableText::set_character_size(int size)
-    { m_text.set_character_size(size); }
+void EditableText::set_character_size(int size) {
+    m_text.set_character_size(size);
+    request_redraw();
+}
 
 void EditableText::set_character_filter(CharFilterFunc && f)
     { m_filter_func = std::move(f); }
@@ -248,11 +256,27 @@ void EditableText::process_focus_event(const sf::Event & event) {
     }
 }
 
-void EditableText::notify_focus_gained()
-    { m_outer.set_color(m_focus_color); }
+void EditableText::notify_focus_gained() {
+    m_outer.set_color(m_focus_color);
+    request_redraw();
+}
+
+void EditableText::notify_focus_lost() {
+    m_outer.set_color(m_reg_color);
+    request_redraw();
+}
 
-void EditableText::notify_focus_lost()
-    { m_outer.set_color(m_reg_color); }
+void EditableText::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_outer);
+    batch.add_rectangle(m_inner);
+    m_text.draw_to_batch(batch);
+    if (need_ellipsis()) {
+        // the ellipsis is drawn over the text, which is in a later bucket
+        batch.flush();
+        m_ellipsis.draw_to_batch(batch);
+    }
+    if (has_focus()) { batch.add_rectangle(m_cursor); }
+}
 
 /* private */ void EditableText::draw
     (sf::RenderTarget & target, sf::RenderStates states) const
@@ -265,6 +289,7 @@ void EditableText::notify_focus_lost()
 }
 
 /* private */ void EditableText::update_geometry() {
+    request_redraw();
     if (width() == 0.f || !m_text.has_font_assigned()) {
         return;
     }
@@ -290,6 +315,7 @@ void EditableText::notify_focus_lost()
     m_cursor.set_position(m_text.character_location(m_text.string().size()));
     m_cursor.set_size    (m_text.line_height() / 3.f, m_text.line_height());
     m_cursor.set_color   (sf::Color::Black);
+    request_redraw();
 }
 
 /* private */ float EditableText::padding() const noexcept
@@ -0,0 +1,97 @@
+/****************************************************************************
+
+    File: EventQueue.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/EventQueue.hpp>
+#include <ksg/Widget.hpp>
+
+#include <stdexcept>
+
+#include <cassert>
+
+namespace ksg {
+
+/* static */ constexpr const std::size_t EventQueue::k_default_capacity;
+
+EventQueue::EventQueue(std::size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument(
+            "EventQueue::EventQueue: capacity must be a positive integer.");
+    }
+    m_events.resize(round_up_to_power_of_two(capacity));
+    m_mask = m_events.size() - 1;
+}
+
+bool EventQueue::push(const sf::Event & event) noexcept {
+    const auto write_pos = m_write_pos.load(std::memory_order_relaxed);
+    if (write_pos - m_cached_read_pos == m_events.size()) {
+        // only refresh from the consumer when we appear to be full
+        m_cached_read_pos = m_read_pos.load(std::memory_order_acquire);
+        if (write_pos - m_cached_read_pos == m_events.size()) return false;
+    }
+    m_events[write_pos & m_mask] = event;
+    m_write_pos.store(write_pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventQueue::pop(sf::Event & event) noexcept {
+    const auto read_pos = m_read_pos.load(std::memory_order_relaxed);
+    if (read_pos == m_cached_write_pos) {
+        // only refresh from the producer when we appear to be empty
+        m_cached_write_pos = m_write_pos.load(std::memory_order_acquire);
+        if (read_pos == m_cached_write_pos) return false;
+    }
+    event = m_events[read_pos & m_mask];
+    m_read_pos.store(read_pos + 1, std::memory_order_release);
+    return true;
+}
+
+std::size_t EventQueue::drain_into(Widget & widget) {
+    const auto read_start = m_read_pos.load(std::memory_order_relaxed);
+    m_cached_write_pos = m_write_pos.load(std::memory_order_acquire);
+    const auto count = m_cached_write_pos - read_start;
+
+    sf::Event event;
+    for (std::size_t i = 0; i != count; ++i) {
+        event = m_events[(read_start + i) & m_mask];
+        // release the slot before processing, so the producer is never held
+        // up by a slow widget tree
+        m_read_pos.store(read_start + i + 1, std::memory_order_release);
+        widget.process_event(event);
+    }
+    return count;
+}
+
+std::size_t EventQueue::size() const noexcept {
+    const auto read_pos  = m_read_pos .load(std::memory_order_acquire);
+    const auto write_pos = m_write_pos.load(std::memory_order_acquire);
+    return write_pos - read_pos;
+}
+
+/* private static */ std::size_t EventQueue::round_up_to_power_of_two
+    (std::size_t x)
+{
+    std::size_t rv = 1;
+    while (rv < x) rv <<= 1;
+    assert(rv >= x);
+    return rv;
+}
+
+} // end of ksg namespace
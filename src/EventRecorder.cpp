@@ -0,0 +1,373 @@
+/****************************************************************************
+
+    File: EventRecorder.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/EventRecorder.hpp>
+#include <ksg/Widget.hpp>
+
+#include <thread>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+#include <cassert>
+
+namespace {
+
+using Event = sf::Event;
+
+// file format:
+// header: magic (4 bytes), version (1 byte)
+// then for each event:
+// time since previous event in us (varint), event type (1 byte), payload
+// all integers are LEB128 varints, signed values are zigzag encoded first;
+// floats are written as their four raw (little endian) bytes
+constexpr const char k_magic[4] = { 'k', 's', 'g', 'e' };
+constexpr const std::uint8_t k_version = 1;
+
+class EventWriter {
+public:
+    explicit EventWriter(std::ostream & out_): m_out(out_) {}
+
+    void write(const Event &);
+
+    void write_unsigned(std::uint64_t);
+
+    void write_signed(std::int64_t);
+
+    void write_float(float);
+
+    void write_byte(std::uint8_t b) { m_out.put(char(b)); }
+
+private:
+    std::ostream & m_out;
+};
+
+class EventReader {
+public:
+    explicit EventReader(std::istream & in_): m_in(in_) {}
+
+    // returns false on end of input or on a malformed event
+    bool read(Event &);
+
+    bool read_unsigned(std::uint64_t &);
+
+    bool read_signed(std::int64_t &);
+
+    bool read_float(float &);
+
+    bool read_byte(std::uint8_t &);
+
+    template <typename T>
+    bool read_signed_as(T & obj) {
+        std::int64_t i;
+        if (!read_signed(i)) return false;
+        obj = T(i);
+        return true;
+    }
+
+    template <typename T>
+    bool read_unsigned_as(T & obj) {
+        std::uint64_t i;
+        if (!read_unsigned(i)) return false;
+        obj = T(i);
+        return true;
+    }
+
+private:
+    std::istream & m_in;
+};
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+EventRecorder::EventRecorder(Widget & root, const std::string & filename):
+    m_root(&root),
+    m_out(filename, std::ios::binary | std::ios::trunc),
+    m_start(Clock::now())
+{
+    if (!m_out) {
+        throw std::runtime_error(
+            "EventRecorder::EventRecorder: cannot open \"" + filename +
+            "\" for writing.");
+    }
+    m_out.write(k_magic, sizeof(k_magic));
+    EventWriter(m_out).write_byte(k_version);
+}
+
+void EventRecorder::process_event(const sf::Event & event) {
+    using namespace std::chrono;
+    auto now = duration_cast<microseconds>(Clock::now() - m_start);
+    EventWriter writer(m_out);
+    writer.write_unsigned(std::uint64_t((now - m_last_time).count()));
+    writer.write(event);
+    m_last_time = now;
+    ++m_count;
+
+    m_root->process_event(event);
+}
+
+void EventRecorder::flush() { m_out.flush(); }
+
+// ----------------------------------------------------------------------------
+
+bool EventPlayer::load_from_file(const std::string & filename) {
+    m_events.clear();
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(k_magic)] = {};
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, k_magic, sizeof(k_magic)) != 0)
+    { return false; }
+
+    EventReader reader(in);
+    std::uint8_t version = 0;
+    if (!reader.read_byte(version) || version != k_version) return false;
+
+    std::vector<RecordedEvent> events;
+    Microseconds time { 0 };
+    std::uint64_t delta = 0;
+    while (reader.read_unsigned(delta)) {
+        RecordedEvent recevent;
+        time += Microseconds(delta);
+        recevent.time = time;
+        // a truncated final record is most likely from an application that
+        // did not exit cleanly, the rest of the recording is still good
+        if (!reader.read(recevent.event)) break;
+        events.push_back(recevent);
+    }
+    m_events.swap(events);
+    return true;
+}
+
+std::vector<EventPlayer::DispatchTime> EventPlayer::replay
+    (Widget & widget, Pacing pacing) const
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<DispatchTime> rv;
+    rv.reserve(m_events.size());
+
+    const auto start = Clock::now();
+    for (const auto & recevent : m_events) {
+        if (pacing == Pacing::k_real_time) {
+            std::this_thread::sleep_until(start + recevent.time);
+        }
+        auto before = Clock::now();
+        widget.process_event(recevent.event);
+        auto after = Clock::now();
+
+        DispatchTime dtime;
+        dtime.recorded_time = recevent.time;
+        dtime.type          = recevent.event.type;
+        dtime.dispatch_time = std::chrono::duration_cast<Nanoseconds>(after - before);
+        rv.push_back(dtime);
+    }
+    return rv;
+}
+
+} // end of ksg namespace
+
+namespace {
+
+void EventWriter::write(const Event & event) {
+    write_byte(std::uint8_t(event.type));
+    switch (event.type) {
+    case Event::Resized:
+        write_unsigned(event.size.width );
+        write_unsigned(event.size.height);
+        break;
+    case Event::TextEntered:
+        write_unsigned(event.text.unicode);
+        break;
+    case Event::KeyPressed: case Event::KeyReleased:
+        write_signed(event.key.code);
+        write_byte(std::uint8_t(  (event.key.alt     ? 1 : 0)
+                                | (event.key.control ? 2 : 0)
+                                | (event.key.shift   ? 4 : 0)
+                                | (event.key.system  ? 8 : 0)));
+        break;
+    case Event::MouseWheelMoved:
+        write_signed(event.mouseWheel.delta);
+        write_signed(event.mouseWheel.x);
+        write_signed(event.mouseWheel.y);
+        break;
+    case Event::MouseWheelScrolled:
+        write_byte(std::uint8_t(event.mouseWheelScroll.wheel));
+        write_float(event.mouseWheelScroll.delta);
+        write_signed(event.mouseWheelScroll.x);
+        write_signed(event.mouseWheelScroll.y);
+        break;
+    case Event::MouseButtonPressed: case Event::MouseButtonReleased:
+        write_byte(std::uint8_t(event.mouseButton.button));
+        write_signed(event.mouseButton.x);
+        write_signed(event.mouseButton.y);
+        break;
+    case Event::MouseMoved:
+        write_signed(event.mouseMove.x);
+        write_signed(event.mouseMove.y);
+        break;
+    case Event::JoystickButtonPressed: case Event::JoystickButtonReleased:
+        write_unsigned(event.joystickButton.joystickId);
+        write_unsigned(event.joystickButton.button);
+        break;
+    case Event::JoystickMoved:
+        write_unsigned(event.joystickMove.joystickId);
+        write_signed(event.joystickMove.axis);
+        write_float(event.joystickMove.position);
+        break;
+    case Event::JoystickConnected: case Event::JoystickDisconnected:
+        write_unsigned(event.joystickConnect.joystickId);
+        break;
+    case Event::TouchBegan: case Event::TouchMoved: case Event::TouchEnded:
+        write_unsigned(event.touch.finger);
+        write_signed(event.touch.x);
+        write_signed(event.touch.y);
+        break;
+    case Event::SensorChanged:
+        write_signed(event.sensor.type);
+        write_float(event.sensor.x);
+        write_float(event.sensor.y);
+        write_float(event.sensor.z);
+        break;
+    default: break; // no payload
+    }
+}
+
+void EventWriter::write_unsigned(std::uint64_t x) {
+    do {
+        auto b = std::uint8_t(x & 0x7F);
+        x >>= 7;
+        write_byte(x ? (b | 0x80) : b);
+    } while (x);
+}
+
+void EventWriter::write_signed(std::int64_t x) {
+    write_unsigned((std::uint64_t(x) << 1) ^ std::uint64_t(x >> 63));
+}
+
+void EventWriter::write_float(float x) {
+    static_assert(sizeof(float) == sizeof(std::uint32_t), "");
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(float));
+    for (int i = 0; i != 4; ++i) {
+        write_byte(std::uint8_t(bits >> (i*8)));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool EventReader::read(Event & event) {
+    std::uint8_t type_byte = 0;
+    if (!read_byte(type_byte) || type_byte >= std::uint8_t(Event::Count))
+        return false;
+    event.type = Event::EventType(type_byte);
+    std::uint8_t b = 0;
+    switch (event.type) {
+    case Event::Resized:
+        return    read_unsigned_as(event.size.width )
+               && read_unsigned_as(event.size.height);
+    case Event::TextEntered:
+        return read_unsigned_as(event.text.unicode);
+    case Event::KeyPressed: case Event::KeyReleased:
+        if (!read_signed_as(event.key.code) || !read_byte(b)) return false;
+        event.key.alt     = (b & 1) != 0;
+        event.key.control = (b & 2) != 0;
+        event.key.shift   = (b & 4) != 0;
+        event.key.system  = (b & 8) != 0;
+        return true;
+    case Event::MouseWheelMoved:
+        return    read_signed_as(event.mouseWheel.delta)
+               && read_signed_as(event.mouseWheel.x)
+               && read_signed_as(event.mouseWheel.y);
+    case Event::MouseWheelScrolled:
+        if (!read_byte(b)) return false;
+        event.mouseWheelScroll.wheel = sf::Mouse::Wheel(b);
+        return    read_float(event.mouseWheelScroll.delta)
+               && read_signed_as(event.mouseWheelScroll.x)
+               && read_signed_as(event.mouseWheelScroll.y);
+    case Event::MouseButtonPressed: case Event::MouseButtonReleased:
+        if (!read_byte(b)) return false;
+        event.mouseButton.button = sf::Mouse::Button(b);
+        return    read_signed_as(event.mouseButton.x)
+               && read_signed_as(event.mouseButton.y);
+    case Event::MouseMoved:
+        return    read_signed_as(event.mouseMove.x)
+               && read_signed_as(event.mouseMove.y);
+    case Event::JoystickButtonPressed: case Event::JoystickButtonReleased:
+        return    read_unsigned_as(event.joystickButton.joystickId)
+               && read_unsigned_as(event.joystickButton.button);
+    case Event::JoystickMoved:
+        return    read_unsigned_as(event.joystickMove.joystickId)
+               && read_signed_as(event.joystickMove.axis)
+               && read_float(event.joystickMove.position);
+    case Event::JoystickConnected: case Event::JoystickDisconnected:
+        return read_unsigned_as(event.joystickConnect.joystickId);
+    case Event::TouchBegan: case Event::TouchMoved: case Event::TouchEnded:
+        return    read_unsigned_as(event.touch.finger)
+               && read_signed_as(event.touch.x)
+               && read_signed_as(event.touch.y);
+    case Event::SensorChanged:
+        return    read_signed_as(event.sensor.type)
+               && read_float(event.sensor.x)
+               && read_float(event.sensor.y)
+               && read_float(event.sensor.z);
+    default: return true; // no payload
+    }
+}
+
+bool EventReader::read_unsigned(std::uint64_t & x) {
+    x = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t b = 0;
+        if (!read_byte(b)) return false;
+        x |= std::uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+bool EventReader::read_signed(std::int64_t & x) {
+    std::uint64_t u = 0;
+    if (!read_unsigned(u)) return false;
+    x = std::int64_t(u >> 1) ^ -std::int64_t(u & 1);
+    return true;
+}
+
+bool EventReader::read_float(float & x) {
+    std::uint32_t bits = 0;
+    for (int i = 0; i != 4; ++i) {
+        std::uint8_t b = 0;
+        if (!read_byte(b)) return false;
+        bits |= std::uint32_t(b) << (i*8);
+    }
+    std::memcpy(&x, &bits, sizeof(float));
+    return true;
+}
+
+bool EventReader::read_byte(std::uint8_t & b) {
+    auto c = m_in.get();
+    if (c == std::istream::traits_type::eof()) return false;
+    b = std::uint8_t(c);
+    return true;
+}
+
+} // end of <anonymous> namespace
@@ -91,17 +91,9 @@ void FrameFocusHandler::process_event(const sf::Event & event) {
     if (new_focus == widgets_end) {
         auto old_itr = m_current_position;
         if (m_advance_func(event)) {
-            if (m_current_position == m_focus_widgets.end()) {
-                m_current_position = m_focus_widgets.begin();
-            } else if (++m_current_position == m_focus_widgets.end()) {
-                m_current_position = m_focus_widgets.begin();
-            }
+            advance_to_visible();
         } else if (m_regress_func(event)) {
-            if (m_current_position == m_focus_widgets.begin()) {
-                m_current_position = m_focus_widgets.end() - 1;
-            } else {
-                --m_current_position;
-            }
+            regress_to_visible();
         }
         if (old_itr != m_current_position) {
             if (old_itr != m_focus_widgets.end())
@@ -141,6 +133,35 @@ void FrameFocusHandler::clear_focus_widgets() {
     return false;
 }
 
+/* private */ void FrameFocusHandler::advance_to_visible() {
+    // hidden widgets (e.g. unused menu entries) are passed over, at most
+    // once around, so that focus stays put if every widget is hidden
+    auto itr = m_current_position;
+    for (std::size_t i = 0; i != m_focus_widgets.size(); ++i) {
+        if (itr == m_focus_widgets.end() || ++itr == m_focus_widgets.end())
+            { itr = m_focus_widgets.begin(); }
+        if ((**itr).is_visible()) {
+            m_current_position = itr;
+            return;
+        }
+    }
+}
+
+/* private */ void FrameFocusHandler::regress_to_visible() {
+    auto itr = m_current_position;
+    for (std::size_t i = 0; i != m_focus_widgets.size(); ++i) {
+        if (itr == m_focus_widgets.begin()) {
+            itr = m_focus_widgets.end() - 1;
+        } else {
+            --itr;
+        }
+        if ((**itr).is_visible()) {
+            m_current_position = itr;
+            return;
+        }
+    }
+}
+
 } // end of detail namespace
 
 } // end of ksg namespace
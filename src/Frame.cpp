@@ -24,16 +24,50 @@
 #include <ksg/Frame.hpp>
 #include <ksg/TextArea.hpp>
 #include <ksg/FocusWidget.hpp>
+#include <ksg/WidgetTimings.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
 #include <stdexcept>
 #include <iostream>
+
+#include <algorithm>
+
+#include <cmath>
 #include <cassert>
 
 namespace {
 
-using VectorF = ksg::Frame::VectorF;
+using VectorF        = ksg::Frame::VectorF;
+using WidgetTimings  = ksg::WidgetTimings;
+using WidgetTimer    = ksg::detail::ScopedWidgetTimer;
+
+// the smallest world space rectangle containing everything a target's
+// current view can show
+sf::FloatRect visible_area_of(const sf::RenderTarget &);
+
+// true only if the widget lies entirely outside of the area, zero sized
+// widgets are treated as points
+bool is_outside(const sf::FloatRect & area, const ksg::Widget &);
+
+sf::FloatRect bounds_of(const ksg::Widget &);
+
+// true for mouse events which happen at a place (moves, clicks and wheels)
+bool is_located_mouse_event(const sf::Event &);
+
+// a mouse move to just above and left of the widget
+sf::Event make_mouse_move_off(const ksg::Widget &);
+
+// removes empty areas, and merges overlapping ones until none overlap, too
+// many areas are merged into one
+void merge_damage(std::vector<sf::FloatRect> &);
+
+// makes a view which only draws to the given area, the area is grown to
+// whole pixels of the target
+// returns false if the area is entirely off the target
+bool make_clipped_view(const sf::RenderTarget &, const sf::View & original,
+                       sf::FloatRect & area, sf::View & clipped);
 
 } // end of <anonymous> namespace
 
@@ -146,9 +180,14 @@ void WidgetAdder::swap(WidgetAdder & rhs) {
     { check_invarients(); }
 
 /* protected */ Frame::Frame(const Frame & lhs):
-    m_padding(lhs.m_padding),
-    m_border (lhs.m_border )
-{}
+    m_padding       (lhs.m_padding       ),
+    m_border        (lhs.m_border        ),
+    m_event_clip    (lhs.m_event_clip    ),
+    m_has_event_clip(lhs.m_has_event_clip)
+{
+    // the cached image itself is not copied, only the setting
+    if (lhs.has_render_cache_enabled()) enable_render_cache();
+}
 
 /* protected */ Frame::Frame(Frame && lhs) { swap(lhs); }
 
@@ -167,15 +206,42 @@ Frame & Frame::operator = (Frame && lhs) {
 
 void Frame::set_location(float x, float y) {
     m_border.set_location(x, y);
+    request_redraw();
     check_invarients();
 }
 
 void Frame::process_event(const sf::Event & event) {
+    // shortcuts take priority over anything the widgets might do with a key
+    if (m_accelerators.process_event(event)) {
+        check_invarients();
+        return;
+    }
     auto gv = m_border.process_event(event);
     if (!gv.skip_other_events) {
-        for (Widget * widget_ptr : m_widgets) {
-            if (widget_ptr->is_visible())
-                widget_ptr->process_event(event);
+        // only events at a place are clipped, keys and text still reach a
+        // focused widget scrolled out of view
+        const bool clipped = m_has_event_clip && is_located_mouse_event(event);
+        if (m_event_clipped.size() != m_widgets.size())
+            { m_event_clipped.assign(m_widgets.size(), false); }
+        for (std::size_t i = 0; i != m_widgets.size(); ++i) {
+            Widget * widget_ptr = m_widgets[i];
+            if (!widget_ptr->is_visible()) continue;
+            if (clipped) {
+                const bool outside = is_outside(m_event_clip, *widget_ptr);
+                const bool was_outside = m_event_clipped[i];
+                m_event_clipped[i] = outside;
+                if (outside) {
+                    // a widget leaving the clip would never learn that the
+                    // mouse left it too, so it is told once
+                    if (!was_outside) {
+                        WidgetTimer timer(*widget_ptr, WidgetTimings::k_process_event);
+                        widget_ptr->process_event(make_mouse_move_off(*widget_ptr));
+                    }
+                    continue;
+                }
+            }
+            WidgetTimer timer(*widget_ptr, WidgetTimings::k_process_event);
+            widget_ptr->process_event(event);
         }
         // perhaps I should process focus requests after the fact to give
         // widgets the opportunity to make a request after an event
@@ -194,8 +260,11 @@ void Frame::set_style(const StyleMap & smap) {
         m_padding = k_default_padding;
     }
 
-    for (Widget * widget_ptr : m_widgets)
+    for (Widget * widget_ptr : m_widgets) {
+        WidgetTimer timer(*widget_ptr, WidgetTimings::k_set_style);
         widget_ptr->set_style(smap);
+    }
+    request_redraw();
     check_invarients();
 }
 
@@ -207,6 +276,7 @@ float Frame::height() const { return m_border.height(); }
 
 void Frame::set_size(float w, float h) {
     m_border.set_size(w, h);
+    request_redraw();
     check_invarients();
 }
 
@@ -242,6 +312,7 @@ void Frame::finalize_widgets(std::vector<Widget *> && widgets,
 
     m_widgets     .swap(widgets);
     m_horz_spacers.swap(spacers);
+    m_event_clipped.clear();
 
     if (styles) {
         set_style(*styles);
@@ -251,23 +322,59 @@ void Frame::finalize_widgets(std::vector<Widget *> && widgets,
     check_invarients();
 }
 
-void Frame::set_padding(float pixels)
-    { m_padding = pixels; }
+void Frame::set_padding(float pixels) {
+    m_padding = pixels;
+    request_redraw();
+}
 
-void Frame::set_frame_border_size(float pixels)
-    { m_border.set_border_size(pixels); }
+void Frame::set_event_clip(const sf::FloatRect & area) {
+    m_event_clip = area;
+    m_has_event_clip = true;
+}
 
-/* protected */ void Frame::draw(sf::RenderTarget & target, sf::RenderStates) const {
+void Frame::clear_event_clip() {
+    m_has_event_clip = false;
+    m_event_clipped.clear();
+}
+
+void Frame::enable_render_cache() {
+    if (m_render_cache) return;
+    m_render_cache = std::make_unique<sf::RenderTexture>();
+    m_render_cache_dirty = true;
+}
+
+void Frame::disable_render_cache()
+    { m_render_cache.reset(); }
+
+void Frame::set_frame_border_size(float pixels) {
+    m_border.set_border_size(pixels);
+    request_redraw();
+}
+
+void Frame::draw_to_batch(DrawBatch & batch) const {
     if (!is_visible()) return;
 
-    target.draw(m_border);
-    for (Widget * widget_ptr : m_widgets) {
-        if (widget_ptr->is_visible())
-            target.draw(*widget_ptr);
+    // the batch may be transformed (e.g. scrolled)
+    const auto visible_area = batch.visible_area();
+    if (is_outside(visible_area, *this)) return;
+
+    if (m_render_cache) {
+        draw_from_cache(batch);
+    } else {
+        draw_contents(batch, visible_area);
     }
 }
 
+/* protected */ void Frame::draw(sf::RenderTarget & target, sf::RenderStates) const {
+    if (m_render_stats) m_render_stats->reset();
+    // flushed on destruction
+    DrawBatch batch(target);
+    batch.set_render_stats(m_render_stats);
+    draw_to_batch(batch);
+}
+
 /* private */ void Frame::finalize_widgets() {
+    WidgetTimer timer(*this, WidgetTimings::k_finalize_widgets);
     // auto sizing
     issue_auto_resize();
 
@@ -333,12 +440,20 @@ void Frame::set_frame_border_size(float pixels)
     });
     m_focus_handler.take_widgets_from(focus_widgets);
 
+    request_redraw();
     check_invarients();
 }
 
 void Frame::swap(Frame & lhs) {
-    std::swap(m_padding, lhs.m_padding);
-    std::swap(m_border , lhs.m_border );
+    std::swap(m_padding       , lhs.m_padding       );
+    std::swap(m_border        , lhs.m_border        );
+    std::swap(m_event_clip    , lhs.m_event_clip    );
+    std::swap(m_has_event_clip, lhs.m_has_event_clip);
+    m_accelerators.swap(lhs.m_accelerators);
+    m_render_cache.swap(lhs.m_render_cache);
+    // contents differ following a swap
+    request_redraw();
+    lhs.request_redraw();
 }
 
 /* private */ VectorF Frame::compute_size_to_fit() const {
@@ -421,8 +536,10 @@ void Frame::swap(Frame & lhs) {
 
 /* private */ void Frame::issue_auto_resize() {
     // ignore auto resize if the frame as a width/height already set
-    for (Widget * widget_ptr : m_widgets)
+    for (Widget * widget_ptr : m_widgets) {
+        WidgetTimer timer(*widget_ptr, WidgetTimings::k_issue_auto_resize);
         widget_ptr->issue_auto_resize();
+    }
 
     issue_auto_resize_for_frame();
 
@@ -461,6 +578,159 @@ void Frame::swap(Frame & lhs) {
     assert(!is_nan(height()) && height() >= 0.f);
 }
 
+const std::vector<sf::FloatRect> & Frame::draw_damaged
+    (sf::RenderTarget & target, sf::Color background)
+{
+    m_damage.clear();
+    collect_damage(m_damage);
+    merge_damage(m_damage);
+    if (m_damage.empty()) return m_damage;
+
+    if (m_render_stats) m_render_stats->reset();
+    const auto original_view = target.getView();
+    auto rect_itr = m_damage.begin();
+    for (auto & area : m_damage) {
+        sf::View clipped;
+        if (!make_clipped_view(target, original_view, area, clipped)) continue;
+        target.setView(clipped);
+
+        DrawBatch batch(target);
+        batch.set_render_stats(m_render_stats);
+        if (background.a != 0) {
+            DrawRectangle back;
+            back.set_position(area.left, area.top);
+            back.set_size(area.width, area.height);
+            back.set_color(background);
+            batch.add_rectangle(back);
+        }
+        draw_to_batch(batch);
+        batch.flush();
+        *rect_itr++ = area;
+    }
+    // only areas actually drawn are reported
+    m_damage.erase(rect_itr, m_damage.end());
+    target.setView(original_view);
+    return m_damage;
+}
+
+/* private */ void Frame::draw_contents
+    (DrawBatch & batch, const sf::FloatRect & visible_area) const
+{
+    m_border.draw_to_batch(batch);
+    for (Widget * widget_ptr : m_widgets) {
+        if (!widget_ptr->is_visible()) continue;
+        if (is_outside(visible_area, *widget_ptr)) continue;
+        WidgetTimer timer(*widget_ptr, WidgetTimings::k_draw);
+        ScopedRenderSubtree subtree(batch.render_stats(), *widget_ptr);
+        widget_ptr->draw_to_batch(batch);
+    }
+}
+
+/* private */ void Frame::draw_from_cache(DrawBatch & batch) const {
+    assert(m_render_cache);
+    auto & cache = *m_render_cache;
+    // textures are sized in whole pixels
+    const auto w = unsigned(std::ceil(width ()));
+    const auto h = unsigned(std::ceil(height()));
+    if (w == 0 || h == 0) return;
+
+    // always poll, so that requests do not linger after they're handled
+    bool needs_rendering = poll_redraw_requests() || m_render_cache_dirty;
+    if (cache.getSize().x < w || cache.getSize().y < h) {
+        // only ever grow, so resizing back and forth does not thrash
+        if (!cache.create(std::max(w, cache.getSize().x),
+                          std::max(h, cache.getSize().y)))
+        {
+            throw std::runtime_error("Frame::draw_from_cache: failed to "
+                                     "create render cache texture.");
+        }
+        needs_rendering = true;
+    }
+
+    if (needs_rendering) {
+        const auto cache_size = cache.getSize();
+        cache.setView(sf::View(sf::FloatRect(
+            location().x, location().y, float(cache_size.x), float(cache_size.y))));
+        cache.clear(sf::Color::Transparent);
+        DrawBatch cache_batch(cache);
+        cache_batch.set_render_stats(batch.render_stats());
+        draw_contents(cache_batch, visible_area_of(cache));
+        cache_batch.flush();
+        cache.display();
+        m_render_cache_dirty = false;
+    }
+
+    // drawn as a batched quad, in a bucket of its own texture
+    const float fw = float(w), fh = float(h);
+    const auto loc = location();
+    const sf::Vertex quad[] = {
+        sf::Vertex(loc                    , VectorF(0.f, 0.f)),
+        sf::Vertex(loc + VectorF(fw , 0.f), VectorF(fw , 0.f)),
+        sf::Vertex(loc + VectorF(fw , fh ), VectorF(fw , fh )),
+        sf::Vertex(loc + VectorF(0.f, fh ), VectorF(0.f, fh ))
+    };
+    batch.add_quad(quad, &cache.getTexture());
+}
+
+/* private */ bool Frame::poll_redraw_requests() const {
+    // every request must be turned off, so no short circuiting
+    bool rv = reset_redraw_request();
+    for (const auto * widget : m_widgets) {
+        if (poll_subtree_redraw_requests(*widget)) rv = true;
+    }
+    if (rv) m_render_cache_dirty = true;
+    return rv;
+}
+
+/* private static */ bool Frame::poll_subtree_redraw_requests
+    (const Widget & widget)
+{
+    if (const auto * frame = dynamic_cast<const Frame *>(&widget))
+        { return frame->poll_redraw_requests(); }
+    // every request must be turned off, so no short circuiting
+    bool rv = widget.reset_redraw_request();
+    // only frames iterate past their immediate children, so any other
+    // widget's children (e.g. a scroll view's) are walked here
+    widget.iterate_const_children_f([&rv](const Widget & child) {
+        if (poll_subtree_redraw_requests(child)) rv = true;
+    });
+    return rv;
+}
+
+/* private */ void Frame::collect_damage(std::vector<sf::FloatRect> & damage) {
+    const auto frame_bounds = bounds_of(*this);
+    // changes to the frame itself (layout included) damage all of it
+    const bool all_damaged =    reset_redraw_request()
+                             || m_drawn_bounds.size() != m_widgets.size();
+    bool any_damaged = all_damaged;
+    if (all_damaged) {
+        damage.push_back(m_drawn_frame_bounds);
+        damage.push_back(frame_bounds);
+    }
+
+    m_drawn_bounds.resize(m_widgets.size());
+    for (std::size_t i = 0; i != m_widgets.size(); ++i) {
+        Widget & widget = *m_widgets[i];
+        const auto bounds = bounds_of(widget);
+        if (auto * frame = dynamic_cast<Frame *>(&widget)) {
+            // nested frames track their own widgets
+            auto old_size = damage.size();
+            frame->collect_damage(damage);
+            if (damage.size() != old_size) any_damaged = true;
+        } else {
+            // a change anywhere below the widget damages all of it
+            if (poll_subtree_redraw_requests(widget)) {
+                damage.push_back(m_drawn_bounds[i]);
+                damage.push_back(bounds);
+                any_damaged = true;
+            }
+        }
+        m_drawn_bounds[i] = bounds;
+    }
+    m_drawn_frame_bounds = frame_bounds;
+    if (any_damaged) m_render_cache_dirty = true;
+}
+
 /* private */ void Frame::update_horizontal_spacers() {
     const float k_horz_space = m_border.width_available_for_widgets();
     const float k_start_x    = 0.f;
@@ -540,3 +810,104 @@ void Frame::swap(Frame & lhs) {
 SimpleFrame::~SimpleFrame() {}
 
 } // end of ksg namespace
+
+namespace {
+
+sf::FloatRect visible_area_of(const sf::RenderTarget & target) {
+    // the inverse view transform maps normalized device coordinates back
+    // into the world, this also covers rotated views
+    return target.getView().getInverseTransform().
+        transformRect(sf::FloatRect(-1.f, -1.f, 2.f, 2.f));
+}
+
+bool is_outside(const sf::FloatRect & area, const ksg::Widget & widget) {
+    auto loc = widget.location();
+    return    loc.x + widget.width () < area.left
+           || loc.y + widget.height() < area.top
+           || loc.x > area.left + area.width
+           || loc.y > area.top  + area.height;
+}
+
+bool is_located_mouse_event(const sf::Event & event) {
+    switch (event.type) {
+    case sf::Event::MouseMoved: case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased: case sf::Event::MouseWheelScrolled:
+        return true;
+    default: return false;
+    }
+}
+
+sf::Event make_mouse_move_off(const ksg::Widget & widget) {
+    sf::Event event;
+    event.type = sf::Event::MouseMoved;
+    event.mouseMove.x = int(std::floor(widget.location().x)) - 1;
+    event.mouseMove.y = int(std::floor(widget.location().y)) - 1;
+    return event;
+}
+
+sf::FloatRect bounds_of(const ksg::Widget & widget)
+    { return sf::FloatRect(widget.location(), VectorF(widget.width(), widget.height())); }
+
+void merge_damage(std::vector<sf::FloatRect> & damage) {
+    static constexpr const std::size_t k_max_damage_areas = 16;
+    auto union_of = [](const sf::FloatRect & a, const sf::FloatRect & b) {
+        float left   = std::min(a.left, b.left);
+        float top    = std::min(a.top , b.top );
+        float right  = std::max(a.left + a.width , b.left + b.width );
+        float bottom = std::max(a.top  + a.height, b.top  + b.height);
+        return sf::FloatRect(left, top, right - left, bottom - top);
+    };
+    damage.erase(std::remove_if(damage.begin(), damage.end(),
+        [](const sf::FloatRect & rect)
+        { return rect.width <= 0.f || rect.height <= 0.f; }),
+        damage.end());
+
+    // merging one pair may cause more overlaps, so repeat until there are
+    // none, lists are short
+    auto merge_one_pair = [&damage, &union_of]() {
+        for (std::size_t i = 0; i < damage.size(); ++i) {
+            for (std::size_t j = i + 1; j < damage.size(); ++j) {
+                if (!damage[i].intersects(damage[j])) continue;
+                damage[i] = union_of(damage[i], damage[j]);
+                damage.erase(damage.begin() + std::ptrdiff_t(j));
+                return true;
+            }
+        }
+        return false;
+    };
+    while (merge_one_pair()) {}
+
+    if (damage.size() <= k_max_damage_areas) return;
+    for (const auto & rect : damage)
+        damage.front() = union_of(damage.front(), rect);
+    damage.resize(1);
+}
+
+bool make_clipped_view(const sf::RenderTarget & target, const sf::View & original,
+                       sf::FloatRect & area, sf::View & clipped)
+{
+    const auto target_size = target.getSize();
+    auto a = target.mapCoordsToPixel(VectorF(area.left, area.top), original);
+    auto b = target.mapCoordsToPixel(
+        VectorF(area.left + area.width, area.top + area.height), original);
+    // pixel mapping truncates, so grow by one pixel all around
+    int left   = std::max(std::min(a.x, b.x) - 1, 0);
+    int top    = std::max(std::min(a.y, b.y) - 1, 0);
+    int right  = std::min(std::max(a.x, b.x) + 1, int(target_size.x));
+    int bottom = std::min(std::max(a.y, b.y) + 1, int(target_size.y));
+    if (right <= left || bottom <= top) return false;
+
+    auto world_a = target.mapPixelToCoords(sf::Vector2i(left , top   ), original);
+    auto world_b = target.mapPixelToCoords(sf::Vector2i(right, bottom), original);
+    area = sf::FloatRect(world_a, world_b - world_a);
+
+    clipped = sf::View(area);
+    clipped.setViewport(sf::FloatRect(
+        float(left)         / float(target_size.x),
+        float(top)          / float(target_size.y),
+        float(right - left) / float(target_size.x),
+        float(bottom - top) / float(target_size.y)));
+    return true;
+}
+
+} // end of <anonymous> namespace
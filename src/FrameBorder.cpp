@@ -22,6 +22,7 @@
 #include <ksg/FrameBorder.hpp>
 #include <ksg/Frame.hpp>
 #include <ksg/TextArea.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -197,6 +198,15 @@ void FrameBorder::set_border_size(float pixels) {
     m_recently_dragged = true;
 }
 
+void FrameBorder::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_back);
+    batch.add_rectangle(m_title_bar);
+    batch.add_rectangle(m_widget_body);
+
+    if (!m_title.string().empty())
+        m_title.draw_to_batch(batch);
+}
+
 /* private */ void FrameBorder::draw
     (sf::RenderTarget & target, sf::RenderStates states) const
 {
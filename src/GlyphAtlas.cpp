@@ -0,0 +1,338 @@
+/****************************************************************************
+
+    File: GlyphAtlas.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/GlyphAtlas.hpp>
+#include <ksg/TextLayoutCache.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+
+#include <stdexcept>
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <cassert>
+
+namespace {
+
+// takes a glyph's bitmap (only alpha is read), and makes an image of its
+// distance field, which is larger by the spread on every side
+sf::Image make_distance_field(const sf::Image & font_page, const sf::IntRect & trect,
+                              int spread);
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+/* static */ constexpr const unsigned GlyphAtlas::k_sdf_base_size;
+/* static */ constexpr const unsigned GlyphAtlas::k_sdf_spread;
+/* private static */ constexpr const unsigned GlyphAtlas::k_staging_width;
+
+/* static */ GlyphAtlas & GlyphAtlas::instance() {
+    static GlyphAtlas inst;
+    return inst;
+}
+
+/* static */ const sf::Shader * GlyphAtlas::sdf_shader() {
+    // GLSL 1.10, as is used by SFML itself, so that software renderers
+    // (e.g. llvmpipe) run it too
+    static const char * const k_fragment_source =
+        "uniform sampler2D texture;\n"
+        "void main() {\n"
+        "    float distance = texture2D(texture, gl_TexCoord[0].xy).a;\n"
+        "    float width = max(fwidth(distance), 0.0001);\n"
+        "    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);\n"
+        "    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a*alpha);\n"
+        "}\n";
+    static std::unique_ptr<sf::Shader> shader;
+    static bool attempted = false;
+    if (!attempted) {
+        attempted = true;
+        if (sf::Shader::isAvailable()) {
+            shader = std::make_unique<sf::Shader>();
+            if (shader->loadFromMemory(k_fragment_source, sf::Shader::Fragment)) {
+                shader->setUniform("texture", sf::Shader::CurrentTexture);
+            } else {
+                shader.reset();
+            }
+        }
+    }
+    return shader.get();
+}
+
+GlyphAtlas::GlyphAtlas(unsigned page_size):
+    m_pages(page_size),
+    m_sdf_pages(page_size)
+{
+    // fields are interpolated between texels when scaled
+    m_sdf_pages.set_smooth(true);
+}
+
+void GlyphAtlas::prepare
+    (const sf::Font & font, unsigned character_size,
+     UStringConstIter beg, UStringConstIter end)
+{ prepare_(font, character_size, beg, end, false); }
+
+const GlyphAtlas::Entry & GlyphAtlas::glyph
+    (const sf::Font & font, unsigned character_size, char32_t c)
+{
+    auto font_itr = m_fonts.find(&font);
+    if (font_itr != m_fonts.end()) {
+        const auto & entries = font_itr->second.entries;
+        auto itr = entries.find(make_key(character_size, c));
+        if (itr != entries.end()) return itr->second;
+    }
+    UString ustr(1, c);
+    prepare(font, character_size, ustr.begin(), ustr.end());
+    return m_fonts[&font].entries[make_key(character_size, c)];
+}
+
+void GlyphAtlas::prepare_sdf
+    (const sf::Font & font, UStringConstIter beg, UStringConstIter end)
+{ prepare_(font, k_sdf_base_size, beg, end, true); }
+
+const GlyphAtlas::Entry & GlyphAtlas::sdf_glyph(const sf::Font & font, char32_t c) {
+    auto font_itr = m_fonts.find(&font);
+    if (font_itr != m_fonts.end()) {
+        const auto & entries = font_itr->second.entries;
+        auto itr = entries.find(make_key(0, c));
+        if (itr != entries.end()) return itr->second;
+    }
+    UString ustr(1, c);
+    prepare_sdf(font, ustr.begin(), ustr.end());
+    return m_fonts[&font].entries[make_key(0, c)];
+}
+
+float GlyphAtlas::KerningTable::amount
+    (char32_t first, char32_t second) const noexcept
+{
+    if (pairs.empty()) return 0.f;
+    const auto key = make_key(first, second);
+    auto itr = std::lower_bound(pairs.begin(), pairs.end(), key,
+        [](const Pair & pair, PairKey key) { return pair.key < key; });
+    if (itr == pairs.end() || itr->key != key) return 0.f;
+    return itr->amount;
+}
+
+float GlyphAtlas::fixed_advance(const sf::Font & font, unsigned character_size) {
+    auto & fixed_advances = m_fonts[&font].fixed_advances;
+    auto itr = fixed_advances.find(character_size);
+    if (itr != fixed_advances.end()) return itr->second;
+
+    float advance = font.getGlyph(U' ', character_size, false).advance;
+    for (char32_t c = U' '; is_metrics_sample(c) && advance != 0.f; ++c) {
+        if (font.getGlyph(c, character_size, false).advance != advance)
+            advance = 0.f;
+    }
+    // a fixed advance is of no use if pairs are kerned anyway
+    if (!kerning_table(font, character_size).is_empty()) advance = 0.f;
+    fixed_advances[character_size] = advance;
+    return advance;
+}
+
+const GlyphAtlas::KerningTable & GlyphAtlas::kerning_table
+    (const sf::Font & font, unsigned character_size)
+{
+    auto & tables = m_fonts[&font].kerning_tables;
+    auto itr = tables.find(character_size);
+    if (itr != tables.end()) return itr->second;
+
+    KerningTable table;
+    // probed in key order, so the table is sorted as it is built
+    for (char32_t a = U' '; is_metrics_sample(a); ++a) {
+        for (char32_t b = U' '; is_metrics_sample(b); ++b) {
+            auto amount = font.getKerning(a, b, character_size);
+            if (amount == 0.f) continue;
+            KerningTable::Pair pair;
+            pair.key    = KerningTable::make_key(a, b);
+            pair.amount = amount;
+            table.pairs.push_back(pair);
+        }
+    }
+    table.pairs.shrink_to_fit();
+    return (tables[character_size] = std::move(table));
+}
+
+void GlyphAtlas::forget_font(const sf::Font & font) {
+    m_fonts.erase(&font);
+    TextLayoutCache::instance().forget_font(&font);
+}
+
+std::size_t GlyphAtlas::glyph_count() const noexcept {
+    std::size_t count = 0;
+    for (const auto & pair : m_fonts) count += pair.second.entries.size();
+    return count;
+}
+
+/* private */ void GlyphAtlas::prepare_
+    (const sf::Font & font, unsigned character_size,
+     UStringConstIter beg, UStringConstIter end, bool as_sdf)
+{
+    auto & entries = m_fonts[&font].entries;
+    const unsigned key_size = as_sdf ? 0 : character_size;
+    std::vector<Key> missing;
+    for (auto itr = beg; itr != end; ++itr) {
+        auto key = make_key(key_size, *itr);
+        if (entries.find(key) != entries.end()) continue;
+        // placeholder, so repeated characters are only added once
+        auto & entry = entries[key];
+        // rasterizes onto SFML's texture for this size
+        entry.glyph = font.getGlyph(*itr, character_size, false);
+        if (entry.glyph.textureRect.width  > 0 &&
+            entry.glyph.textureRect.height > 0)
+        { missing.push_back(key); }
+    }
+    if (missing.empty()) return;
+
+    // only the new glyphs are copied, onto a staging target, and then read
+    // back together (rather than the whole of SFML's texture for this size)
+    std::vector<sf::Vector2i> staged_at;
+    staged_at.reserve(missing.size());
+    sf::Vector2u staging_size;
+    {
+    sf::Vector2u shelf;
+    unsigned shelf_height = 0;
+    for (auto key : missing) {
+        const auto & trect = entries[key].glyph.textureRect;
+        if (shelf.x > 0 && shelf.x + unsigned(trect.width) > k_staging_width) {
+            shelf.x = 0;
+            shelf.y += shelf_height;
+            shelf_height = 0;
+        }
+        staged_at.emplace_back(int(shelf.x), int(shelf.y));
+        shelf.x += unsigned(trect.width);
+        shelf_height = std::max(shelf_height, unsigned(trect.height));
+        staging_size.x = std::max(staging_size.x, shelf.x);
+    }
+    staging_size.y = shelf.y + shelf_height;
+    }
+    const auto staged = stage_glyphs(font.getTexture(character_size), staging_size,
+                                     entries, missing, staged_at);
+
+    for (std::size_t i = 0; i != missing.size(); ++i) {
+        auto & entry = entries[missing[i]];
+        const sf::IntRect srect(staged_at[i], sf::Vector2i(
+            entry.glyph.textureRect.width, entry.glyph.textureRect.height));
+        if (as_sdf) {
+            static constexpr const float k_spread = float(k_sdf_spread);
+            auto region = m_sdf_pages.add_image(
+                make_distance_field(staged, srect, int(k_sdf_spread)));
+            entry.glyph.bounds.left   -= k_spread;
+            entry.glyph.bounds.top    -= k_spread;
+            entry.glyph.bounds.width  += k_spread*2.f;
+            entry.glyph.bounds.height += k_spread*2.f;
+            entry.glyph.textureRect = region.texture_rectangle;
+            entry.texture           = region.texture;
+            continue;
+        }
+        sf::Image glyph_image;
+        glyph_image.create(unsigned(srect.width), unsigned(srect.height),
+                           sf::Color::Transparent);
+        glyph_image.copy(staged, 0, 0, srect);
+        auto region = m_pages.add_image(glyph_image);
+        entry.glyph.textureRect = region.texture_rectangle;
+        entry.texture           = region.texture;
+    }
+}
+
+/* private */ sf::Image GlyphAtlas::stage_glyphs
+    (const sf::Texture & font_page, sf::Vector2u size, const EntryMap & entries,
+     const std::vector<Key> & keys, const std::vector<sf::Vector2i> & staged_at)
+{
+    // the target only grows, so that it is seldom recreated
+    if (m_staging.getSize().x < size.x || m_staging.getSize().y < size.y) {
+        if (!m_staging.create(std::max(m_staging.getSize().x, size.x),
+                              std::max(m_staging.getSize().y, size.y)))
+        {
+            throw std::runtime_error("GlyphAtlas::stage_glyphs: cannot create "
+                                     "staging target.");
+        }
+    }
+    m_staging.clear(sf::Color::Transparent);
+    // copied as is, rather than blended onto the cleared target
+    const sf::RenderStates states(sf::BlendNone);
+    for (std::size_t i = 0; i != keys.size(); ++i) {
+        sf::Sprite sprite(font_page, entries.at(keys[i]).glyph.textureRect);
+        sprite.setPosition(sf::Vector2f(staged_at[i]));
+        m_staging.draw(sprite, states);
+    }
+    m_staging.display();
+    return m_staging.getTexture().copyToImage();
+}
+
+} // end of ksg namespace
+
+namespace {
+
+sf::Image make_distance_field
+    (const sf::Image & font_page, const sf::IntRect & trect, int spread)
+{
+    const int w = trect.width, h = trect.height;
+    auto is_inside = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= w || y >= h) return false;
+        return font_page.getPixel(unsigned(trect.left + x),
+                                  unsigned(trect.top  + y)).a >= 128;
+    };
+    std::vector<bool> inside(std::size_t(w*h));
+    for (int y = 0; y != h; ++y) {
+        for (int x = 0; x != w; ++x) {
+            inside[std::size_t(x + y*w)] = is_inside(x, y);
+        }
+    }
+    auto inside_at = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= w || y >= h) return false;
+        return bool(inside[std::size_t(x + y*w)]);
+    };
+
+    sf::Image field;
+    const int fw = w + spread*2, fh = h + spread*2;
+    field.create(unsigned(fw), unsigned(fh), sf::Color::Transparent);
+    for (int fy = 0; fy != fh; ++fy) {
+        for (int fx = 0; fx != fw; ++fx) {
+            const int x = fx - spread, y = fy - spread;
+            const bool here = inside_at(x, y);
+            // nearest pixel of the other kind, searched only as far as the
+            // spread, glyphs are rasterized once so brute force will do
+            int best = spread*spread;
+            for (int dy = -spread; dy <= spread; ++dy) {
+                for (int dx = -spread; dx <= spread; ++dx) {
+                    int dist = dx*dx + dy*dy;
+                    if (dist >= best) continue;
+                    if (inside_at(x + dx, y + dy) != here) best = dist;
+                }
+            }
+            float distance = std::sqrt(float(best));
+            if (!here) distance = -distance;
+            float value = 0.5f + distance / float(spread*2);
+            value = std::max(0.f, std::min(1.f, value));
+            field.setPixel(unsigned(fx), unsigned(fy), sf::Color(255, 255, 255,
+                           std::uint8_t(std::round(value*255.f))));
+        }
+    }
+    return field;
+}
+
+} // end of <anonymous> namespace
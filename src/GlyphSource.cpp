@@ -0,0 +1,178 @@
+/****************************************************************************
+
+    File: GlyphSource.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/GlyphSource.hpp>
+#include <ksg/BitmapFont.hpp>
+
+#include <algorithm>
+
+#include <cassert>
+
+namespace {
+
+using Entry = ksg::detail::GlyphSource::Entry;
+
+Entry scale_entry(Entry, float scale);
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+namespace detail {
+
+GlyphSource::GlyphSource(const sf::Font & font, int character_size, bool as_sdf):
+    m_font(&font),
+    m_character_size(character_size),
+    m_as_sdf(as_sdf)
+{
+    if (character_size < 1) return;
+    if (as_sdf) {
+        m_scale = float(character_size) / float(GlyphAtlas::k_sdf_base_size);
+    }
+    auto & atlas = GlyphAtlas::instance();
+    // distance field metrics (kerning included) are those of the base size,
+    // scaled, so that they match the glyphs
+    m_metrics_size =
+        as_sdf ? GlyphAtlas::k_sdf_base_size : unsigned(character_size);
+    m_fixed_advance = atlas.fixed_advance(font, m_metrics_size)*m_scale;
+    m_kerning_table = &atlas.kerning_table(font, m_metrics_size);
+}
+
+GlyphSource::GlyphSource(const BitmapFont & font, int character_size):
+    m_bitmap_font(&font),
+    m_character_size(character_size)
+{
+    if (font.baked_size() != 0)
+        m_scale = float(character_size) / float(font.baked_size());
+    m_fixed_advance = font.fixed_advance()*m_scale;
+}
+
+void GlyphSource::prepare(UStringConstIter beg, UStringConstIter end) const {
+    if (!m_font || m_character_size < 1) return;
+    if (m_as_sdf) {
+        GlyphAtlas::instance().prepare_sdf(*m_font, beg, end);
+    } else {
+        GlyphAtlas::instance().prepare
+            (*m_font, unsigned(m_character_size), beg, end);
+    }
+}
+
+GlyphSource::Entry GlyphSource::glyph(char32_t c) const {
+    if (m_bitmap_font) {
+        const auto & rec = m_bitmap_font->glyph(c);
+        Entry entry;
+        entry.glyph   = rec.glyph;
+        entry.texture = m_bitmap_font->page_texture(rec.page);
+        return scale_entry(entry, m_scale);
+    }
+    assert(m_font);
+    if (m_as_sdf) {
+        return scale_entry(GlyphAtlas::instance().sdf_glyph(*m_font, c), m_scale);
+    }
+    return GlyphAtlas::instance().glyph(*m_font, unsigned(m_character_size), c);
+}
+
+float GlyphSource::advance_of(char32_t c) const {
+    if (m_fixed_advance != 0.f && GlyphAtlas::is_metrics_sample(c))
+        return m_fixed_advance;
+    return metrics_of(c).advance;
+}
+
+float GlyphSource::kerning(char32_t first, char32_t second) const {
+    if (m_bitmap_font) return m_bitmap_font->kerning(first, second)*m_scale;
+    if (!m_kerning_table) return 0.f;
+    if (GlyphAtlas::is_metrics_sample(first) &&
+        GlyphAtlas::is_metrics_sample(second))
+    { return m_kerning_table->amount(first, second)*m_scale; }
+    return m_font->getKerning(first, second, m_metrics_size)*m_scale;
+}
+
+bool GlyphSource::has_kerning(UStringConstIter beg, UStringConstIter end) const {
+    if (m_bitmap_font) return m_bitmap_font->has_kerning();
+    if (!m_kerning_table) return false;
+    if (!m_kerning_table->is_empty()) return true;
+    // SFML cannot say whether pairs beyond the sample are kerned, so any
+    // other character must be looked up
+    return std::any_of(beg, end,
+        [](char32_t c) { return !GlyphAtlas::is_metrics_sample(c); });
+}
+
+float GlyphSource::line_spacing() const {
+    if (m_bitmap_font) return m_bitmap_font->line_spacing()*m_scale;
+    return m_font->getLineSpacing(unsigned(m_character_size));
+}
+
+float GlyphSource::baseline() const {
+    if (m_bitmap_font) return m_bitmap_font->baseline()*m_scale;
+    // SFML does not give the ascent, the character size is near enough
+    return float(m_character_size);
+}
+
+float GlyphSource::measure_width(UStringConstIter beg, UStringConstIter end) const {
+    if (m_character_size < 1) return 0.f;
+    assert(beg <= end);
+    // a fixed advance means no pair in the sample is kerned, so text only
+    // of sample characters is simply as wide as its length
+    if (m_fixed_advance != 0.f && std::all_of(beg, end, GlyphAtlas::is_metrics_sample))
+        { return m_fixed_advance*float(end - beg); }
+    const bool kerned = has_kerning(beg, end);
+    float w = 0.f;
+    for (auto itr = beg; itr != end; ++itr) {
+        w += advance_of(*itr);
+        if (kerned && itr + 1 != end) w += kerning(*itr, *(itr + 1));
+    }
+    return w;
+}
+
+float GlyphSource::maximum_height(UStringConstIter beg, UStringConstIter end) const {
+    if (m_character_size < 1) return 0.f;
+    float h = 0.f;
+    for (auto itr = beg; itr != end; ++itr) {
+        h = std::max(h, metrics_of(*itr).bounds.height);
+    }
+    return h;
+}
+
+const sf::Shader * GlyphSource::shader() const
+    { return m_as_sdf ? GlyphAtlas::sdf_shader() : nullptr; }
+
+/* private */ sf::Glyph GlyphSource::metrics_of(char32_t c) const {
+    if (m_font && !m_as_sdf)
+        return m_font->getGlyph(c, unsigned(m_character_size), false);
+    return glyph(c).glyph;
+}
+
+} // end of detail namespace
+
+} // end of ksg namespace
+
+namespace {
+
+Entry scale_entry(Entry entry, float scale) {
+    if (scale == 1.f) return entry;
+    auto & bounds = entry.glyph.bounds;
+    bounds = sf::FloatRect(bounds.left*scale , bounds.top*scale,
+                           bounds.width*scale, bounds.height*scale);
+    entry.glyph.advance *= scale;
+    return entry;
+}
+
+} // end of <anonymous> namespace
@@ -0,0 +1,157 @@
+/****************************************************************************
+
+    File: ImageAtlas.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/ImageAtlas.hpp>
+
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+
+#include <cassert>
+
+namespace ksg {
+
+/* static */ constexpr const unsigned ImageAtlas::k_default_page_size;
+/* private static */ constexpr const unsigned ImageAtlas::k_padding;
+
+ImageAtlas::ImageAtlas(unsigned page_size):
+    m_page_size(std::min(page_size, sf::Texture::getMaximumSize()))
+{
+    if (m_page_size <= k_padding*2) {
+        throw std::invalid_argument("ImageAtlas::ImageAtlas: page size is "
+                                    "too small to hold any image.");
+    }
+}
+
+ImageAtlas::Region ImageAtlas::add_image(const sf::Image & image) {
+    const auto size = image.getSize();
+    if (size.x == 0 || size.y == 0) {
+        throw std::invalid_argument("ImageAtlas::add_image: image is empty.");
+    }
+    if (size.x + k_padding*2 > m_page_size || size.y + k_padding*2 > m_page_size) {
+        throw std::invalid_argument("ImageAtlas::add_image: image is larger "
+                                    "than a page.");
+    }
+
+    std::size_t page_idx = 0;
+    sf::Vector2u pos;
+    if (!find_place(size.x, size.y, page_idx, pos)) {
+        add_page();
+        page_idx = m_pages.size() - 1;
+        bool found = find_place(size.x, size.y, page_idx, pos);
+        assert(found);
+        (void)found;
+    }
+
+    auto & texture = *m_pages[page_idx].texture;
+    texture.update(image, pos.x, pos.y);
+    m_used_area += std::size_t(size.x)*std::size_t(size.y);
+
+    Region rv;
+    rv.texture           = &texture;
+    rv.texture_rectangle = sf::IntRect(int(pos.x), int(pos.y), int(size.x), int(size.y));
+    rv.page              = page_idx;
+    return rv;
+}
+
+ImageAtlas::Region ImageAtlas::add_image_from_file(const std::string & filename) {
+    sf::Image image;
+    if (!image.loadFromFile(filename)) {
+        throw std::runtime_error("ImageAtlas::add_image_from_file: cannot "
+                                 "load image \"" + filename + "\".");
+    }
+    return add_image(image);
+}
+
+const sf::Texture & ImageAtlas::page_texture(std::size_t page) const
+    { return *m_pages.at(page).texture; }
+
+void ImageAtlas::set_smooth(bool smooth) {
+    m_smooth = smooth;
+    for (auto & page : m_pages) page.texture->setSmooth(smooth);
+}
+
+double ImageAtlas::packing_efficiency() const noexcept {
+    if (m_pages.empty()) return 0.;
+    double page_area = double(m_page_size)*double(m_page_size);
+    return double(m_used_area) / (page_area*double(m_pages.size()));
+}
+
+/* private */ bool ImageAtlas::find_place
+    (unsigned w, unsigned h, std::size_t & page_idx, sf::Vector2u & pos)
+{
+    const unsigned padded_w = w + k_padding*2;
+    const unsigned padded_h = h + k_padding*2;
+
+    // best fit: the existing shelf which wastes the least height
+    Shelf * best = nullptr;
+    std::size_t best_page = 0;
+    unsigned least_waste = std::numeric_limits<unsigned>::max();
+    for (std::size_t i = page_idx; i != m_pages.size(); ++i) {
+        for (auto & shelf : m_pages[i].shelves) {
+            if (shelf.height < padded_h || shelf.end + padded_w > m_page_size)
+                continue;
+            if (shelf.height - padded_h >= least_waste) continue;
+            least_waste = shelf.height - padded_h;
+            best        = &shelf;
+            best_page   = i;
+        }
+    }
+
+    // otherwise start a new shelf on the first page with room left
+    if (!best) {
+        for (std::size_t i = page_idx; i != m_pages.size(); ++i) {
+            auto & page = m_pages[i];
+            if (page.used_height + padded_h > m_page_size) continue;
+            Shelf shelf;
+            shelf.top    = page.used_height;
+            shelf.height = padded_h;
+            page.used_height += padded_h;
+            page.shelves.push_back(shelf);
+            best      = &page.shelves.back();
+            best_page = i;
+            break;
+        }
+    }
+    if (!best) return false;
+
+    pos = sf::Vector2u(best->end + k_padding, best->top + k_padding);
+    best->end += padded_w;
+    page_idx = best_page;
+    return true;
+}
+
+/* private */ void ImageAtlas::add_page() {
+    Page page;
+    page.texture = std::make_unique<sf::Texture>();
+    if (!page.texture->create(m_page_size, m_page_size)) {
+        throw std::runtime_error("ImageAtlas::add_page: cannot create page "
+                                 "texture.");
+    }
+    // new textures have undefined contents, padding must be transparent
+    sf::Image blank;
+    blank.create(m_page_size, m_page_size, sf::Color::Transparent);
+    page.texture->update(blank);
+    page.texture->setSmooth(m_smooth);
+    m_pages.push_back(std::move(page));
+}
+
+} // end of ksg namespace
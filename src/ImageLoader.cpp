@@ -0,0 +1,139 @@
+/****************************************************************************
+
+    File: ImageLoader.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/ImageLoader.hpp>
+#include <ksg/ImageWidget.hpp>
+#include <ksg/TextureCache.hpp>
+
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <cassert>
+
+namespace ksg {
+
+/* static */ constexpr const std::size_t ImageLoader::k_default_uploads_per_frame;
+
+/* static */ ImageLoader & ImageLoader::instance() {
+    static ImageLoader inst;
+    return inst;
+}
+
+/* static */ std::size_t ImageLoader::default_worker_count() {
+    static constexpr const std::size_t k_max_default_workers = 4;
+    std::size_t hardware = std::thread::hardware_concurrency();
+    // zero if unknown
+    if (hardware < 2) return 1;
+    return std::min(hardware - 1, k_max_default_workers);
+}
+
+ImageLoader::ImageLoader(std::size_t worker_count) {
+    if (worker_count == 0) {
+        throw std::invalid_argument("ImageLoader::ImageLoader: there must be "
+                                    "at least one worker.");
+    }
+    m_workers.reserve(worker_count);
+    for (std::size_t i = 0; i != worker_count; ++i) {
+        m_workers.emplace_back([this]() { run_worker(); });
+    }
+}
+
+ImageLoader::~ImageLoader() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_job_added.notify_all();
+    for (auto & worker : m_workers) worker.join();
+}
+
+ImageLoader::PendingPtr ImageLoader::load
+    (const std::string & filename, ImageWidget & owner)
+{
+    auto pending = std::make_shared<detail::PendingImageLoad>();
+    pending->filename = filename;
+    pending->owner    = &owner;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobs.push_back(pending);
+    }
+    m_job_added.notify_one();
+    return pending;
+}
+
+std::size_t ImageLoader::upload_finished(std::size_t max_uploads) {
+    std::size_t uploads = 0;
+    while (uploads != max_uploads) {
+        PendingPtr pending;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_finished.empty()) break;
+            pending = std::move(m_finished.front());
+            m_finished.pop_front();
+        }
+
+        auto * owner = pending->owner;
+        // the widget is no longer waiting, either way
+        pending->owner = nullptr;
+        // cancelled or failed loads do not count toward the limit
+        if (!owner || !pending->decoded) continue;
+
+        auto texture = std::make_shared<sf::Texture>();
+        if (texture->loadFromImage(pending->image)) {
+            // another widget may have loaded the same file meanwhile
+            owner->set_texture_shared_pointer(TextureCache::instance().
+                insert(pending->filename, std::move(texture)));
+        }
+        pending->image = sf::Image();
+        ++uploads;
+    }
+    return uploads;
+}
+
+std::size_t ImageLoader::pending_count() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_jobs.size() + m_finished.size();
+}
+
+/* private */ void ImageLoader::run_worker() {
+    while (true) {
+        PendingPtr pending;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job_added.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+            pending = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        // loading an image does not need a graphics context
+        if (!pending->cancelled) {
+            pending->decoded = pending->image.loadFromFile(pending->filename);
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.push_back(std::move(pending));
+    }
+}
+
+} // end of ksg namespace
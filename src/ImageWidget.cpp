@@ -22,8 +22,13 @@
 #include <ksg/ImageWidget.hpp>
 
 #include <common/Util.hpp>
+#include <ksg/DrawBatch.hpp>
+#include <ksg/TextureCache.hpp>
+
 #include <SFML/Graphics/RenderTarget.hpp>
 
+#include <stdexcept>
+
 #include <cassert>
 
 namespace {
@@ -39,23 +44,89 @@ const char * const CANNOT_UPLOAD_TEXTURE_MSG =
 
 namespace ksg {
 
+ImageWidget::ImageWidget(const ImageWidget & rhs):
+    Widget(rhs),
+    m_texture_storage(rhs.m_texture_storage),
+    m_spt            (rhs.m_spt            ),
+    m_size           (rhs.m_size           )
+{ update_sprite_texture(); }
+
+ImageWidget::ImageWidget(ImageWidget && rhs):
+    Widget(rhs),
+    m_texture_storage(std::move(rhs.m_texture_storage)),
+    m_spt            (rhs.m_spt ),
+    m_size           (rhs.m_size),
+    m_pending        (std::move(rhs.m_pending))
+{
+    if (m_pending && m_pending->owner == &rhs) m_pending->owner = this;
+    update_sprite_texture();
+}
+
+ImageWidget::~ImageWidget() { cancel_pending_load(); }
+
+ImageWidget & ImageWidget::operator = (const ImageWidget & rhs) {
+    if (this != &rhs) {
+        ImageWidget temp(rhs);
+        *this = std::move(temp);
+    }
+    return *this;
+}
+
+ImageWidget & ImageWidget::operator = (ImageWidget && rhs) {
+    if (this == &rhs) return *this;
+    cancel_pending_load();
+    Widget::operator = (rhs);
+    m_texture_storage = std::move(rhs.m_texture_storage);
+    m_spt             = rhs.m_spt ;
+    m_size            = rhs.m_size;
+    m_pending         = std::move(rhs.m_pending);
+    if (m_pending && m_pending->owner == &rhs) m_pending->owner = this;
+    update_sprite_texture();
+    request_redraw();
+    return *this;
+}
+
 bool ImageWidget::load_from_file(const char * filename) noexcept {
-    auto & texture = m_texture_storage.reset<sf::Texture>();
-    if (texture.loadFromFile(filename)) {
-        m_spt.setTexture(texture);
-        update_size_post_load();
-        check_invarients();
-        return true;
-    } else {
+    cancel_pending_load();
+    TextureCache::TexturePtr texture;
+    // the cache may throw (e.g. on allocation), which must not escape here
+    try {
+        texture = TextureCache::instance().load(filename);
+    } catch (std::exception &) {
         return false;
     }
+    if (!texture) return false;
+    set_texture_shared_pointer(std::move(texture));
+    return true;
+}
+
+void ImageWidget::load_from_file_async
+    (const std::string & filename, VectorF placeholder_size)
+{
+    cancel_pending_load();
+    if (auto cached = TextureCache::instance().find(filename)) {
+        set_texture_shared_pointer(std::move(cached));
+        if (placeholder_size != VectorF()) {
+            set_size(placeholder_size.x, placeholder_size.y);
+        }
+        return;
+    }
+    // show nothing until loaded
+    unset_texture();
+    if (placeholder_size != VectorF()) {
+        m_size = placeholder_size;
+    }
+    m_pending = ImageLoader::instance().load(filename, *this);
+    request_redraw();
+    check_invarients();
 }
 
 void ImageWidget::load_from_image(const sf::Image & image) {
+    cancel_pending_load();
     auto & texture = m_texture_storage.reset<sf::Texture>();
     if (!texture.loadFromImage(image))
         throw Error(CANNOT_UPLOAD_TEXTURE_MSG);
-    m_spt.setTexture(texture);
+    m_spt.setTexture(texture, true);
     update_size_post_load();
     check_invarients();
 }
@@ -63,8 +134,23 @@ void ImageWidget::load_from_image(const sf::Image & image) {
 void ImageWidget::set_texture
     (const sf::Texture & texture_, const sf::IntRect & trect_)
 {
+    cancel_pending_load();
     const auto & texture = m_texture_storage.reset<sf::Texture>(texture_);
-    m_spt.setTexture(texture);
+    m_spt.setTexture(texture, true);
+    if (trect_ != sf::IntRect())
+        m_spt.setTextureRect(trect_ );
+    update_size_post_load();
+    check_invarients();
+}
+
+void ImageWidget::set_texture
+    (sf::Texture && texture_, const sf::IntRect & trect_)
+{
+    cancel_pending_load();
+    // sf::Texture has no move constructor, but swapping moves only handles
+    auto & texture = m_texture_storage.reset<sf::Texture>();
+    texture.swap(texture_);
+    m_spt.setTexture(texture, true);
     if (trect_ != sf::IntRect())
         m_spt.setTextureRect(trect_ );
     update_size_post_load();
@@ -74,23 +160,52 @@ void ImageWidget::set_texture
 void ImageWidget::set_texture_shared_pointer
     (std::shared_ptr<const sf::Texture> shrd_ptr)
 {
+    cancel_pending_load();
+    if (!shrd_ptr) {
+        unset_texture();
+        return;
+    }
     m_texture_storage = TextureMultiType(shrd_ptr);
-    m_spt.setTexture(*shrd_ptr);
+    m_spt.setTexture(*shrd_ptr, true);
     update_size_post_load();
     check_invarients();
 }
 
 void ImageWidget::assign_texture(const sf::Texture * tptr) {
+    cancel_pending_load();
+    if (!tptr) {
+        unset_texture();
+        return;
+    }
     m_texture_storage = TextureMultiType(tptr);
+    // any rectangle (e.g. of an atlas region) belongs to the old texture
+    m_spt.setTexture(*tptr, true);
+    update_size_post_load();
+    check_invarients();
+}
+
+void ImageWidget::set_atlas_region(const ImageAtlas::Region & region) {
+    if (!region.texture) {
+        throw std::invalid_argument("ImageWidget::set_atlas_region: region "
+                                    "does not refer to an atlas page.");
+    }
+    cancel_pending_load();
+    m_texture_storage = TextureMultiType(region.texture);
+    m_spt.setTexture(*region.texture);
+    m_spt.setTextureRect(region.texture_rectangle);
     update_size_post_load();
     check_invarients();
 }
 
-void ImageWidget::reset_texture_rectangle(const sf::IntRect & trect_)
-    { m_spt.setTextureRect(trect_); }
+void ImageWidget::reset_texture_rectangle(const sf::IntRect & trect_) {
+    m_spt.setTextureRect(trect_);
+    request_redraw();
+}
 
-void ImageWidget::set_location(float x, float y)
-    { m_spt.setPosition(x, y); }
+void ImageWidget::set_location(float x, float y) {
+    m_spt.setPosition(x, y);
+    request_redraw();
+}
 
 VectorF ImageWidget::location() const { return m_spt.getPosition(); }
 
@@ -104,6 +219,22 @@ void ImageWidget::set_size(float w, float h) {
     check_invarients();
 }
 
+void ImageWidget::draw_to_batch(DrawBatch & batch) const {
+    if (!m_spt.getTexture()) return;
+    const auto & trect     = m_spt.getTextureRect();
+    const auto & transform = m_spt.getTransform();
+    const float w = float(trect.width), h = float(trect.height);
+    const float tx = float(trect.left), ty = float(trect.top);
+    const auto color = m_spt.getColor();
+    const sf::Vertex quad[] = {
+        sf::Vertex(transform.transformPoint(0.f, 0.f), color, VectorF(tx    , ty    )),
+        sf::Vertex(transform.transformPoint(w  , 0.f), color, VectorF(tx + w, ty    )),
+        sf::Vertex(transform.transformPoint(w  , h  ), color, VectorF(tx + w, ty + h)),
+        sf::Vertex(transform.transformPoint(0.f, h  ), color, VectorF(tx    , ty + h))
+    };
+    batch.add_quad(quad, m_spt.getTexture());
+}
+
 /* private */ void ImageWidget::draw
     (sf::RenderTarget & target, sf::RenderStates) const
     { target.draw(m_spt); }
@@ -116,11 +247,36 @@ void ImageWidget::set_size(float w, float h) {
     }
 }
 
+/* private */ void ImageWidget::cancel_pending_load() {
+    if (!m_pending) return;
+    if (m_pending->owner == this) {
+        m_pending->owner = nullptr;
+        // saves the worker from decoding it, if it has not already
+        m_pending->cancelled = true;
+    }
+    m_pending.reset();
+}
+
+/* private */ void ImageWidget::unset_texture() {
+    auto loc = m_spt.getPosition();
+    m_texture_storage = TextureMultiType();
+    m_spt = sf::Sprite();
+    m_spt.setPosition(loc);
+    request_redraw();
+    check_invarients();
+}
+
+/* private */ void ImageWidget::update_sprite_texture() {
+    if (!m_texture_storage.is_type<sf::Texture>()) return;
+    m_spt.setTexture(m_texture_storage.as<sf::Texture>());
+}
+
 /* private */ void ImageWidget::update_size_post_load() {
     const auto & rect = m_spt.getTextureRect();
     if (rect.width != 0.f && rect.height != 0.f) {
         m_spt.setScale(m_size.x / rect.width, m_size.y / rect.height);
     }
+    request_redraw();
 }
 
 } // end of ksg namespace
@@ -23,6 +23,7 @@
 #include <ksg/Frame.hpp>
 #include <ksg/TextButton.hpp>
 #include <ksg/TextArea.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -108,6 +109,7 @@ void OptionsSlider::set_style(const StyleMap & smap) {
 #   endif
     set_if_color_found(smap, Button::k_regular_front_color, m_front);
     set_if_color_found(smap, Button::k_regular_back_color , m_back );
+    request_redraw();
 
     // setting style should not invoke any kind of geometry update
 }
@@ -187,6 +189,14 @@ void OptionsSlider::set_wrap_enabled(bool b) {
     }
 }
 
+void OptionsSlider::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_back);
+    batch.add_rectangle(m_front);
+    m_text.draw_to_batch(batch);
+    m_left_arrow .draw_to_batch(batch);
+    m_right_arrow.draw_to_batch(batch);
+}
+
 /* private */ void OptionsSlider::draw
     (sf::RenderTarget & target, sf::RenderStates) const
 {
@@ -229,6 +239,7 @@ void OptionsSlider::set_wrap_enabled(bool b) {
     float height_diff = m_front.height() - m_text.height();
     m_text.set_location(m_front.x() + std::max(0.f, width_diff  / 2.f),
                         m_front.y() + std::max(0.f, height_diff / 2.f));
+    request_redraw();
 }
 
 /* private */ float OptionsSlider::padding() const noexcept
@@ -20,6 +20,7 @@
 *****************************************************************************/
 
 #include <ksg/ProgressBar.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -86,14 +87,20 @@ void ProgressBar::set_style(const StyleMap & smap) {
     update_sizes_using_outer();
 }
 
-void ProgressBar::set_outer_color(sf::Color color_)
-    { m_outer.set_color(color_); }
+void ProgressBar::set_outer_color(sf::Color color_) {
+    m_outer.set_color(color_);
+    request_redraw();
+}
 
-void ProgressBar::set_inner_front_color(sf::Color color_)
-    { m_inner_front.set_color(color_); }
+void ProgressBar::set_inner_front_color(sf::Color color_) {
+    m_inner_front.set_color(color_);
+    request_redraw();
+}
 
-void ProgressBar::set_inner_back_color(sf::Color color_)
-    { m_inner_back.set_color(color_); }
+void ProgressBar::set_inner_back_color(sf::Color color_) {
+    m_inner_back.set_color(color_);
+    request_redraw();
+}
 
 void ProgressBar::set_fill_amount(float fill_amount) {
     if (fill_amount < 0.f or fill_amount > 1.f)
@@ -110,6 +117,12 @@ void ProgressBar::set_padding(float p) {
     update_sizes_using_outer();
 }
 
+void ProgressBar::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_outer      );
+    batch.add_rectangle(m_inner_back );
+    batch.add_rectangle(m_inner_front);
+}
+
 /* protected */ void ProgressBar::draw
     (sf::RenderTarget & target, sf::RenderStates) const
 {
@@ -133,6 +146,7 @@ void ProgressBar::set_padding(float p) {
     auto padding = active_padding();
     m_inner_back .set_position(x + padding, y + padding);
     m_inner_front.set_position(x + padding, y + padding);
+    request_redraw();
 }
 
 /* private */ void ProgressBar::update_sizes_using_outer() {
@@ -142,6 +156,7 @@ void ProgressBar::set_padding(float p) {
     m_inner_back .set_size(width - pad*2.f, height - pad*2.f);
     m_inner_front.set_size((width - pad*2.f)*m_fill_amount,
                            height - pad*2.f                );
+    request_redraw();
 }
 
 } // end of namespace ksg
@@ -0,0 +1,104 @@
+/****************************************************************************
+
+    File: RenderStats.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/RenderStats.hpp>
+
+#include <stdexcept>
+
+#include <cassert>
+
+namespace ksg {
+
+/* static */ constexpr const std::size_t RenderStats::k_primitive_type_count;
+
+void RenderStats::record_draw
+    (sf::PrimitiveType type, std::size_t vertex_count, const sf::Texture * texture)
+{
+    assert(std::size_t(type) < k_primitive_type_count);
+    record_texture(texture, true);
+    ++m_totals.draw_calls;
+    ++m_totals.primitive_draws[std::size_t(type)];
+    m_totals.vertices += vertex_count;
+    for (auto * counts : m_active_subtrees) {
+        ++counts->draw_calls;
+        ++counts->primitive_draws[std::size_t(type)];
+    }
+}
+
+void RenderStats::record_unbatched_draw() {
+    record_texture(nullptr, false);
+    ++m_totals.draw_calls;
+    ++m_totals.unbatched_draws;
+    for (auto * counts : m_active_subtrees) {
+        ++counts->draw_calls;
+        ++counts->unbatched_draws;
+    }
+}
+
+void RenderStats::record_added_vertices(std::size_t vertex_count) {
+    for (auto * counts : m_active_subtrees) {
+        counts->vertices += vertex_count;
+    }
+}
+
+void RenderStats::push_subtree(const Widget & widget)
+    { m_active_subtrees.push_back(&m_subtrees[&widget]); }
+
+void RenderStats::pop_subtree() {
+    if (m_active_subtrees.empty()) {
+        throw std::runtime_error("RenderStats::pop_subtree: there are no "
+                                 "subtrees to pop.");
+    }
+    m_active_subtrees.pop_back();
+}
+
+void RenderStats::reset() {
+    m_totals = Counts();
+    m_subtrees.clear();
+    m_active_subtrees.clear();
+    m_last_texture = nullptr;
+    m_last_texture_known = false;
+}
+
+const RenderStats::Counts * RenderStats::subtree_counts
+    (const Widget & widget) const
+{
+    auto itr = m_subtrees.find(&widget);
+    return itr == m_subtrees.end() ? nullptr : &itr->second;
+}
+
+/* private */ void RenderStats::record_texture
+    (const sf::Texture * texture, bool is_known)
+{
+    // the very first draw is not a switch, anything unknown is
+    bool is_first = m_totals.draw_calls == 0;
+    bool is_switch = !is_first &&
+        (!is_known || !m_last_texture_known || texture != m_last_texture);
+    m_last_texture       = texture;
+    m_last_texture_known = is_known;
+    if (!is_switch) return;
+    ++m_totals.texture_switches;
+    for (auto * counts : m_active_subtrees) {
+        ++counts->texture_switches;
+    }
+}
+
+} // end of ksg namespace
@@ -0,0 +1,213 @@
+/****************************************************************************
+
+    File: ScrollView.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/ScrollView.hpp>
+#include <ksg/DrawBatch.hpp>
+
+#include <SFML/Window/Event.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace {
+
+using VectorF = ksg::ScrollView::VectorF;
+
+void set_mouse_location(sf::Event &, VectorF);
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+/* static */ constexpr const float ScrollView::k_default_scroll_step;
+
+void ScrollView::set_child(Widget & widget) {
+    if (&widget == this) {
+        throw std::invalid_argument("ScrollView::set_child: a view cannot "
+                                    "scroll itself.");
+    }
+    m_child = &widget;
+    m_child->set_location(m_bounds.left, m_bounds.top);
+    m_offset = VectorF();
+    request_redraw();
+}
+
+void ScrollView::unset_child() {
+    m_child = nullptr;
+    m_offset = VectorF();
+    request_redraw();
+}
+
+void ScrollView::process_event(const sf::Event & event) {
+    if (!m_child) return;
+    switch (event.type) {
+    case sf::Event::MouseWheelScrolled: {
+        const auto & scroll = event.mouseWheelScroll;
+        if (!contains(scroll.x, scroll.y)) break;
+        // wheels scroll content the other way to their delta
+        const float distance = -scroll.delta*m_scroll_step;
+        if (scroll.wheel == sf::Mouse::HorizontalWheel) {
+            scroll_by(distance, 0.f);
+        } else {
+            scroll_by(0.f, distance);
+        }
+        return;
+    }
+    case sf::Event::MouseMoved: {
+        auto local = event;
+        set_mouse_location(local, map_to_child(event.mouseMove.x, event.mouseMove.y));
+        m_child->process_event(local);
+        return;
+    }
+    case sf::Event::MouseButtonPressed: case sf::Event::MouseButtonReleased: {
+        auto local = event;
+        set_mouse_location(local, map_to_child(event.mouseButton.x, event.mouseButton.y));
+        m_child->process_event(local);
+        return;
+    }
+    default: break;
+    }
+    m_child->process_event(event);
+}
+
+void ScrollView::set_location(float x, float y) {
+    m_bounds.left = x;
+    m_bounds.top  = y;
+    // only ever moved with the view, never while scrolling
+    if (m_child) m_child->set_location(x, y);
+    request_redraw();
+}
+
+VectorF ScrollView::location() const
+    { return VectorF(m_bounds.left, m_bounds.top); }
+
+void ScrollView::set_size(float width_, float height_) {
+    if (width_ < 0.f || height_ < 0.f) {
+        throw std::invalid_argument("ScrollView::set_size: width and height "
+                                    "must be non-negative real numbers.");
+    }
+    m_bounds.width  = width_;
+    m_bounds.height = height_;
+    scroll_to(m_offset.x, m_offset.y);
+    request_redraw();
+}
+
+float ScrollView::width() const {
+    if (m_bounds.width == 0.f && m_child) return m_child->width();
+    return m_bounds.width;
+}
+
+float ScrollView::height() const {
+    if (m_bounds.height == 0.f && m_child) return m_child->height();
+    return m_bounds.height;
+}
+
+void ScrollView::set_style(const StyleMap & smap) {
+    if (m_child) m_child->set_style(smap);
+}
+
+void ScrollView::issue_auto_resize() {
+    if (!m_child) return;
+    m_child->issue_auto_resize();
+    // the child's size may have changed
+    scroll_to(m_offset.x, m_offset.y);
+}
+
+void ScrollView::draw_to_batch(DrawBatch & batch) const {
+    if (!m_child || !m_child->is_visible()) return;
+    ScopedClip clip(batch, sf::FloatRect(m_bounds.left, m_bounds.top, width(), height()));
+    if (batch.is_clipped_out()) return;
+    sf::Transform scroll;
+    scroll.translate(-m_offset.x, -m_offset.y);
+    ScopedTransform scrolled(batch, scroll);
+    m_child->draw_to_batch(batch);
+}
+
+void ScrollView::set_scroll_step(float step) {
+    if (!(step > 0.f)) {
+        throw std::invalid_argument("ScrollView::set_scroll_step: step must "
+                                    "be a positive real number.");
+    }
+    m_scroll_step = step;
+}
+
+void ScrollView::scroll_to(float x, float y) {
+    const auto max_offset = maximum_scroll_offset();
+    // whole pixels, so that text stays crisp
+    VectorF offset(std::round(std::max(0.f, std::min(x, max_offset.x))),
+                   std::round(std::max(0.f, std::min(y, max_offset.y))));
+    if (offset == m_offset) return;
+    m_offset = offset;
+    request_redraw();
+}
+
+void ScrollView::scroll_by(float dx, float dy)
+    { scroll_to(m_offset.x + dx, m_offset.y + dy); }
+
+VectorF ScrollView::maximum_scroll_offset() const {
+    if (!m_child) return VectorF();
+    return VectorF(std::max(0.f, m_child->width () - width ()),
+                   std::max(0.f, m_child->height() - height()));
+}
+
+/* private */ void ScrollView::draw
+    (sf::RenderTarget & target, sf::RenderStates states) const
+{
+    DrawBatch batch(target, states);
+    draw_to_batch(batch);
+}
+
+/* private */ void ScrollView::iterate_children_(ChildWidgetIterator & itr)
+    { if (m_child) itr.on_child(*m_child); }
+
+/* private */ void ScrollView::iterate_const_children_
+    (ChildWidgetIterator & itr) const
+{ if (m_child) itr.on_child(static_cast<const Widget &>(*m_child)); }
+
+/* private */ bool ScrollView::contains(int x, int y) const noexcept {
+    const float fx = float(x), fy = float(y);
+    return    fx >= m_bounds.left && fx < m_bounds.left + width ()
+           && fy >= m_bounds.top  && fy < m_bounds.top  + height();
+}
+
+/* private */ VectorF ScrollView::map_to_child(int x, int y) const {
+    if (contains(x, y)) return VectorF(float(x), float(y)) + m_offset;
+    // just above and left of the child, where nothing of it may be
+    return m_child->location() - VectorF(1.f, 1.f);
+}
+
+} // end of ksg namespace
+
+namespace {
+
+void set_mouse_location(sf::Event & event, VectorF r) {
+    const int x = int(std::floor(r.x)), y = int(std::floor(r.y));
+    if (event.type == sf::Event::MouseMoved) {
+        event.mouseMove.x = x;
+        event.mouseMove.y = y;
+    } else {
+        event.mouseButton.x = x;
+        event.mouseButton.y = y;
+    }
+}
+
+} // end of <anonymous> namespace
@@ -21,9 +21,13 @@
 
 #include <ksg/SelectionMenu.hpp>
 #include <ksg/TextArea.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Window/Event.hpp>
+
+#include <algorithm>
+#include <cmath>
 #if 0
 #include <iostream>
 #endif
@@ -42,6 +46,14 @@ namespace ksg {
 
 SelectionEntryReciever::~SelectionEntryReciever() {}
 
+void SelectionEntryReciever::notify_focused(std::size_t) {}
+
+std::size_t SelectionEntryReciever::focused_index(std::size_t menu_idx) const
+    { return menu_idx; }
+
+bool SelectionEntryReciever::scroll_focus_past(std::size_t, bool)
+    { return false; }
+
 // ----------------------------------------------------------------------------
 #if 0
 SelectionEntry::SelectionEntry():
@@ -51,8 +63,11 @@ SelectionEntry::SelectionEntry():
 {}
 #endif
 void SelectionEntry::assign_parent(SelectionEntryReciever & parent, std::size_t menu_idx) {
+    const bool rebinding = m_parent;
     m_parent   = &parent;
     m_menu_idx = menu_idx;
+    // focus may be on another index now
+    if (rebinding) update_highlight();
 }
 
 void SelectionEntry::set_string(const UString & ustr) {
@@ -95,6 +110,8 @@ const UString & SelectionEntry::string() const
 void SelectionEntry::set_style(const StyleMap & styles) {
 
     using SelMenu = SelectionMenu;
+    // entries (e.g. "..") are often repeated across menus
+    m_display_text.enable_shared_layout();
     m_display_text.assign_font(styles, styles::k_global_font);
     if (auto * color = styles::find<sf::Color>(styles, TextArea::k_text_color)) {
         m_display_text.set_color(*color);
@@ -124,6 +141,7 @@ void SelectionEntry::set_style(const StyleMap & styles) {
     }
 #   endif
     m_background.set_color(m_no_highlight);
+    request_redraw();
 }
 
 float SelectionEntry::content_width() const
@@ -155,6 +173,11 @@ float SelectionEntry::content_height() const
     }
 }
 
+void SelectionEntry::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_background);
+    m_display_text.draw_to_batch(batch);
+}
+
 /* private */ void SelectionEntry::draw
     (sf::RenderTarget & target, sf::RenderStates states) const
 {
@@ -168,34 +191,51 @@ float SelectionEntry::content_height() const
     }
     if (event.type == sf::Event::KeyReleased) {
         if (event.key.code == sf::Keyboard::Return) {
-            m_parent->activate(m_menu_idx);
+            m_parent->activate(m_parent->focused_index(m_menu_idx));
         }
     }
+    using FocusHandler = detail::FrameFocusHandler;
+    const bool advancing = FocusHandler::default_focus_advance(event);
+    if (!advancing && !FocusHandler::default_focus_regress(event)) return;
+    // requesting focus overrides the frame moving it on
+    if (m_parent->scroll_focus_past(m_menu_idx, advancing))
+        request_focus();
 }
 
-/* private */ void SelectionEntry::notify_focus_gained()
-    { update_highlight(); }
+/* private */ void SelectionEntry::notify_focus_gained() {
+    if (m_parent)
+        m_parent->notify_focused(m_menu_idx);
+    update_highlight();
+}
 
 /* private */ void SelectionEntry::notify_focus_lost() {
     update_highlight();
     if (m_parent)
-        m_parent->deactivate(m_menu_idx);
+        m_parent->deactivate(m_parent->focused_index(m_menu_idx));
 }
 
 /* private */ void SelectionEntry::update_highlight() {
-    if (has_focus() && m_mouse_is_over) {
+    const bool focused = shows_focus();
+    if (focused && m_mouse_is_over) {
         m_background.set_color(m_max_highlight);
-    } else if (has_focus() || m_mouse_is_over) {
+    } else if (focused || m_mouse_is_over) {
         m_background.set_color(m_reg_highlight);
     } else {
         m_background.set_color(m_no_highlight);
     }
+    request_redraw();
+}
+
+/* private */ bool SelectionEntry::shows_focus() const {
+    if (!has_focus()) return false;
+    return !m_parent || m_parent->focused_index(m_menu_idx) == m_menu_idx;
 }
 
 /* private */ void SelectionEntry::recenter_text() {
     m_display_text.set_location(
         m_background.x() + (m_background.width () - m_display_text.width ())*0.5f,
         m_background.y() + (m_background.height() - m_display_text.height())*0.5f);
+    request_redraw();
 }
 
 /* private */ float SelectionEntry::padding() const noexcept
@@ -210,49 +250,215 @@ float SelectionEntry::content_height() const
 /* private static */ constexpr const std::size_t SelectionMenu::k_uninit;
 
 void SelectionMenu::add_options(std::vector<UString> && options) {
-    if (!m_entries.empty()) {
-        if (m_entries.size() != options.size()) {
-            throw std::invalid_argument(
-                "SelectionMenu::add_options: due to limitations of this "
-                "library, this selection menu cannot change the number of "
-                "entries it has");
+    check_owns_options("add_options");
+    const bool was_empty = m_entries.empty();
+    float row_height = entry_height();
+    // entries already made are reused, rather than made again
+    const auto reused = std::min(m_entries.size(), options.size());
+    for (std::size_t i = 0; i != reused; ++i) {
+        m_entries[i]->set_string(std::move(options[i]));
+    }
+    while (m_entries.size() > options.size()) {
+        release_entry(*m_entries.back());
+        m_entries.pop_back();
+    }
+    for (auto itr = options.begin() + reused; itr != options.end(); ++itr) {
+        auto & entry = make_entry();
+        entry.assign_parent(*this, m_entries.size());
+        entry.set_string(std::move(*itr));
+        m_entries.push_back(&entry);
+    }
+    if (was_empty) {
+        for (const auto * entry : m_entries) {
+            m_bounds.width = std::max(m_bounds.width, entry->content_width());
+            row_height     = std::max(row_height, entry->content_height());
         }
     }
-    m_entries.reserve(options.size());
-    for (auto opt : options) {
-        m_entries.emplace_back();
-        SelectionEntry & entry = m_entries.back();
-        entry.assign_parent(*this, m_entries.size() - 1);
-        entry.set_string(std::move(opt));
-        entry.set_size(width(), height() / float(options.size()));
+    for (auto * entry : m_entries) {
+        entry->set_size(m_bounds.width, row_height);
     }
+    // rows keep their height, so the menu grows (or shrinks) with the count
+    m_bounds.height = row_height*float(m_entries.size());
+    place_rows(0);
+    if (m_last_selected != k_uninit && m_last_selected >= m_entries.size())
+        { m_last_selected = k_uninit; }
+    if (m_focused != k_uninit && m_focused >= m_entries.size())
+        { m_focused = k_uninit; }
+    update_selection_highlight();
+    request_redraw();
     options.clear();
 }
 
+void SelectionMenu::insert_option(std::size_t index, UString && option) {
+    check_owns_options("insert_option");
+    if (index > m_entries.size()) {
+        throw std::out_of_range(
+            "SelectionMenu::insert_option: index must not be greater than the "
+            "number of options.");
+    }
+    auto & entry = make_entry();
+    entry.set_string(std::move(option));
+    float row_height = entry_height();
+    if (m_entries.empty()) {
+        m_bounds.width = std::max(m_bounds.width, entry.content_width());
+        row_height     = entry.content_height();
+    }
+    entry.set_size(m_bounds.width, row_height);
+    m_entries.insert(m_entries.begin() + std::ptrdiff_t(index), &entry);
+    m_bounds.height = row_height*float(m_entries.size());
+
+    if (m_last_selected != k_uninit && m_last_selected >= index) ++m_last_selected;
+    if (m_focused       != k_uninit && m_focused       >= index) ++m_focused;
+    // only rows from the new option onward have moved
+    place_rows(index);
+    update_selection_highlight();
+    request_redraw();
+}
+
+void SelectionMenu::erase_option(std::size_t index) {
+    check_owns_options("erase_option");
+    if (index >= m_entries.size()) {
+        throw std::out_of_range(
+            "SelectionMenu::erase_option: index must be less than the number "
+            "of options.");
+    }
+    const float row_height = entry_height();
+    release_entry(*m_entries[index]);
+    m_entries.erase(m_entries.begin() + std::ptrdiff_t(index));
+    m_bounds.height = row_height*float(m_entries.size());
+
+    if (m_last_selected == index) {
+        m_last_selected = k_uninit;
+    } else if (m_last_selected != k_uninit && m_last_selected > index) {
+        --m_last_selected;
+    }
+    if (m_focused == index) {
+        m_focused = k_uninit;
+    } else if (m_focused != k_uninit && m_focused > index) {
+        --m_focused;
+    }
+    place_rows(index);
+    update_selection_highlight();
+    request_redraw();
+}
+
+void SelectionMenu::replace_option(std::size_t index, UString && option) {
+    check_owns_options("replace_option");
+    if (index >= m_entries.size()) {
+        throw std::out_of_range(
+            "SelectionMenu::replace_option: index must be less than the "
+            "number of options.");
+    }
+    // nothing moves, so only this option is laid out again
+    m_entries[index]->set_string(std::move(option));
+    request_redraw();
+}
+
+void SelectionMenu::set_data_source
+    (CountFunc count_func, OptionFunc option_func, std::size_t visible_count)
+{
+    if (!count_func || !option_func) {
+        throw std::invalid_argument(
+            "SelectionMenu::set_data_source: both count and option functions "
+            "must be set.");
+    }
+    if (visible_count == 0) {
+        throw std::invalid_argument(
+            "SelectionMenu::set_data_source: at least one option must be "
+            "visible.");
+    }
+    m_count_func  = std::move(count_func );
+    m_option_func = std::move(option_func);
+    while (m_entries.size() > visible_count) {
+        release_entry(*m_entries.back());
+        m_entries.pop_back();
+    }
+    while (m_entries.size() != visible_count) {
+        auto & entry = make_entry();
+        entry.assign_parent(*this, m_entries.size());
+        entry.set_size(width(), height() / float(visible_count));
+        m_entries.push_back(&entry);
+    }
+    m_first_visible = 0;
+    m_last_selected = m_focused = k_uninit;
+    refresh_data_source();
+}
+
+void SelectionMenu::refresh_data_source() {
+    if (!has_data_source()) {
+        throw std::runtime_error(
+            "SelectionMenu::refresh_data_source: this menu has no data "
+            "source.");
+    }
+    m_option_count = m_count_func();
+    if (m_last_selected != k_uninit && m_last_selected >= m_option_count)
+        { m_last_selected = k_uninit; }
+    if (m_focused != k_uninit && m_focused >= m_option_count)
+        { m_focused = k_uninit; }
+    // rebinds regardless of whether the first option changed
+    m_first_visible = std::min(m_first_visible, last_first_visible());
+    bind_entries();
+}
+
+std::size_t SelectionMenu::option_count() const
+    { return has_data_source() ? m_option_count : m_entries.size(); }
+
+void SelectionMenu::scroll_to_option(std::size_t index) {
+    if (index >= option_count()) {
+        throw std::out_of_range(
+            "SelectionMenu::scroll_to_option: index must be less than the "
+            "number of options.");
+    }
+    // without a data source, every option is always present
+    if (!has_data_source()) return;
+    if (index < m_first_visible) {
+        set_first_visible(index);
+    } else if (index >= m_first_visible + m_entries.size()) {
+        set_first_visible(index + 1 - m_entries.size());
+    }
+}
+
 void SelectionMenu::set_size(float width_, float height_) {
     m_bounds.width = width_;
     m_bounds.height = height_;
-    for (auto & entry : m_entries) {
-        entry.set_size(width_, height_ / float(m_entries.size()));
+    for (auto * entry : m_entries) {
+        entry->set_size(width_, height_ / float(m_entries.size()));
     }
+    update_selection_highlight();
 }
 
 /* static */ void SelectionMenu::default_response_function
     (std::size_t, const UString &) {}
 
 /* private */ void SelectionMenu::process_event(const sf::Event & event) {
-    for (auto & entry : m_entries) {
-        entry.process_event(event);
+    if (has_data_source() && event.type == sf::Event::MouseWheelScrolled) {
+        const auto & scroll = event.mouseWheelScroll;
+        if (   scroll.wheel == sf::Mouse::VerticalWheel
+            && m_bounds.contains(float(scroll.x), float(scroll.y)))
+        {
+            // one option per step, wheels scroll the other way to their delta
+            auto steps = long(std::round(-scroll.delta));
+            if (steps == 0) steps = scroll.delta > 0.f ? -1 : 1;
+            if (steps < 0 && std::size_t(-steps) > m_first_visible) {
+                set_first_visible(0);
+            } else {
+                set_first_visible(m_first_visible + std::size_t(steps));
+            }
+            return;
+        }
+    }
+    for (auto * entry : m_entries) {
+        // entries past the last option are hidden
+        if (!entry->is_visible()) continue;
+        entry->process_event(event);
     }
 }
 
 /* private */ void SelectionMenu::set_location(float x, float y) {
     m_bounds.left = x;
     m_bounds.top  = y;
-    for (auto & entry : m_entries) {
-        entry.set_location(x, y);
-        y += m_bounds.height / float(m_entries.size());
-    }
+    place_rows(0);
+    update_selection_highlight();
 }
 
 /* private */ VectorF SelectionMenu::location() const {
@@ -268,54 +474,198 @@ void SelectionMenu::set_size(float width_, float height_) {
 }
 
 /* private */ void SelectionMenu::set_style(const StyleMap & smap) {
-    for (auto & wid : m_entries) {
+    // kept for entries made later
+    m_styles = std::make_shared<const StyleMap>(smap);
+    for (auto & wid : m_entry_store) {
         wid.set_style(smap);
     }
 }
 
 /* private */ void SelectionMenu::iterate_children_(ChildWidgetIterator & itr) {
-    for (auto & wid : m_entries) itr.on_child(wid);
+    for (auto * wid : m_entries) itr.on_child(*wid);
 }
 
 /* private */ void SelectionMenu::iterate_const_children_(ChildWidgetIterator & itr) const {
-    for (const auto & wid : m_entries) itr.on_child(wid);
+    for (const SelectionEntry * wid : m_entries) itr.on_child(*wid);
 }
 
 /* private */ void SelectionMenu::draw
     (sf::RenderTarget & target, sf::RenderStates states) const
 {
     target.draw(m_selected);
-    for (const auto & wid : m_entries) {
-        target.draw(wid, states);
+    for (const SelectionEntry * wid : m_entries) {
+        if (!wid->is_visible()) continue;
+        target.draw(*wid, states);
+    }
+}
+
+/* private */ void SelectionMenu::draw_to_batch(DrawBatch & batch) const {
+    batch.add_rectangle(m_selected);
+    if (m_entries.empty()) return;
+    // entries are evenly spaced, so only those in view need be looked at
+    // (long menus are usually scrolled)
+    const auto visible = batch.visible_area();
+    const float count = float(m_entries.size());
+    const float entry_height = m_bounds.height / count;
+    float first = 0.f, last = count;
+    if (entry_height > 0.f) {
+        first = std::floor((visible.top - m_bounds.top) / entry_height);
+        last  = std::ceil ((visible.top + visible.height - m_bounds.top) / entry_height);
+        first = std::max(0.f, std::min(first, count));
+        last  = std::max(0.f, std::min(last , count));
+    }
+    for (auto i = std::size_t(first); i < std::size_t(last); ++i) {
+        if (!m_entries[i]->is_visible()) continue;
+        m_entries[i]->draw_to_batch(batch);
     }
 }
 
 /* private */ void SelectionMenu::activate(std::size_t index) {
-    m_resp_func(index, m_entries[index].string());
-    auto entry_height = m_bounds.height / float(m_entries.size());
-    m_selected.set_position(m_bounds.left, m_bounds.top + entry_height*float(index));
-    m_selected.set_size(m_bounds.width, entry_height);
+    if (index >= option_count()) return;
+    if (has_data_source()) {
+        m_resp_func(index, m_option_func(index));
+    } else {
+        m_resp_func(index, m_entries[index]->string());
+    }
     m_last_selected = index;
+    update_selection_highlight();
+    request_redraw();
 }
 
 /* private */ void SelectionMenu::deactivate(std::size_t index) {
+    if (m_focused == index) m_focused = k_uninit;
     if (m_last_selected == index) {
+        m_last_selected = k_uninit;
         m_selected = DrawRectangle();
+        request_redraw();
     }
 }
 
+/* private */ void SelectionMenu::notify_focused(std::size_t index)
+    { m_focused = index; }
+
+/* private */ std::size_t SelectionMenu::focused_index(std::size_t index) const {
+    // without a data source, entries never change index
+    if (!has_data_source() || m_focused == k_uninit) return index;
+    return m_focused;
+}
+
+/* private */ bool SelectionMenu::scroll_focus_past
+    (std::size_t index, bool forward)
+{
+    if (!has_data_source()) return false;
+    // only from either end of the visible window, elsewhere focus moves to
+    // the neighbouring entry as usual
+    if (forward) {
+        if (   index + 1 != m_first_visible + m_entries.size()
+            || index + 1 >= m_option_count)
+        { return false; }
+        scroll_to_option(index + 1);
+    } else {
+        if (index != m_first_visible || index == 0) return false;
+        scroll_to_option(index - 1);
+    }
+    return true;
+}
+
 /* private */ void SelectionMenu::issue_auto_resize() {
     float entry_width  = 0.f;
     float entry_height = 0.f;
-    for (const auto & wid : m_entries) {
-        entry_width  = std::max(entry_width , wid.content_width ());
-        entry_height = std::max(entry_height, wid.content_height());
+    for (const SelectionEntry * wid : m_entries) {
+        entry_width  = std::max(entry_width , wid->content_width ());
+        entry_height = std::max(entry_height, wid->content_height());
     }
-    for (auto & wid : m_entries) {
-        wid.set_size(entry_width, entry_height);
+    for (auto * wid : m_entries) {
+        wid->set_size(entry_width, entry_height);
     }
     m_bounds.width  = entry_width;
     m_bounds.height = entry_height*float(m_entries.size());
+    update_selection_highlight();
+}
+
+/* private */ void SelectionMenu::bind_entries() {
+    for (std::size_t i = 0; i != m_entries.size(); ++i) {
+        auto & entry = *m_entries[i];
+        const auto index = m_first_visible + i;
+        const bool has_option = index < m_option_count;
+        entry.assign_parent(*this, index);
+        entry.set_string(has_option ? m_option_func(index) : UString());
+        entry.set_visible(has_option);
+    }
+    update_selection_highlight();
+    request_redraw();
+}
+
+/* private */ void SelectionMenu::set_first_visible(std::size_t index) {
+    index = std::min(index, last_first_visible());
+    if (index == m_first_visible) return;
+    m_first_visible = index;
+    bind_entries();
+}
+
+/* private */ void SelectionMenu::place_rows(std::size_t first) {
+    const float row_height = entry_height();
+    for (auto i = first; i < m_entries.size(); ++i) {
+        auto & entry = *m_entries[i];
+        // with a data source, entries are bound by bind_entries instead
+        if (!has_data_source()) entry.assign_parent(*this, i);
+        entry.set_location(m_bounds.left, m_bounds.top + row_height*float(i));
+    }
+}
+
+/* private */ SelectionEntry & SelectionMenu::make_entry() {
+    if (!m_free_entries.empty()) {
+        auto & entry = *m_free_entries.back();
+        m_free_entries.pop_back();
+        entry.set_visible(true);
+        return entry;
+    }
+    // a deque never moves its elements on growing, as frames keep pointers
+    // to focus widgets
+    m_entry_store.emplace_back();
+    auto & entry = m_entry_store.back();
+    entry.assign_parent(*this, k_uninit);
+    if (m_styles) entry.set_style(*m_styles);
+    return entry;
+}
+
+/* private */ void SelectionMenu::release_entry(SelectionEntry & entry) {
+    // released entries are kept (hidden) for reuse, as their frame may still
+    // refer to them
+    entry.assign_parent(*this, k_uninit);
+    entry.set_string(UString());
+    entry.set_visible(false);
+    m_free_entries.push_back(&entry);
+}
+
+/* private */ void SelectionMenu::check_owns_options(const char * caller) const {
+    if (!has_data_source()) return;
+    throw std::runtime_error(
+        std::string("SelectionMenu::") + caller + ": cannot change options of "
+        "a menu which has a data source, change the source and refresh it "
+        "instead.");
+}
+
+/* private */ std::size_t SelectionMenu::last_first_visible() const noexcept {
+    if (m_option_count <= m_entries.size()) return 0;
+    return m_option_count - m_entries.size();
+}
+
+/* private */ void SelectionMenu::update_selection_highlight() {
+    if (   m_last_selected == k_uninit || m_last_selected < m_first_visible
+        || m_last_selected - m_first_visible >= m_entries.size())
+    {
+        m_selected = DrawRectangle();
+        return;
+    }
+    const auto row = m_last_selected - m_first_visible;
+    m_selected.set_position(m_bounds.left, m_bounds.top + entry_height()*float(row));
+    m_selected.set_size(m_bounds.width, entry_height());
+}
+
+/* private */ float SelectionMenu::entry_height() const noexcept {
+    if (m_entries.empty()) return 0.f;
+    return m_bounds.height / float(m_entries.size());
 }
 
 namespace detail {
@@ -26,8 +26,13 @@
 #include <ksg/TextArea.hpp>
 #include <ksg/ProgressBar.hpp>
 #include <ksg/SelectionMenu.hpp>
+#include <ksg/GlyphAtlas.hpp>
+#include <ksg/BitmapFont.hpp>
+#include <ksg/TextLayoutCache.hpp>
 
 #include <stdexcept>
+#include <algorithm>
+#include <vector>
 
 #include <cassert>
 
@@ -35,6 +40,8 @@ using Error = std::runtime_error;
 
 namespace {
 
+const sf::Font * font_from_field(const ksg::StylesField &);
+
 template <typename T>
 void add_style(ksg::StyleMap & smap, const char * key, const T & val)
     { smap[key] = ksg::StylesField(val); }
@@ -90,9 +97,69 @@ StyleMap construct_system_styles() {
 }
 
 StylesField load_font(const std::string & filename) {
-    auto sptr = std::make_shared<sf::Font>();
+    // the atlas (and layout cache) know fonts by address, so must forget
+    // this one before another font could take its place
+    std::shared_ptr<sf::Font> sptr(new sf::Font(), [](sf::Font * font) {
+        GlyphAtlas::instance().forget_font(*font);
+        delete font;
+    });
     if (sptr->loadFromFile(filename)) {
-        return StylesField(std::shared_ptr<const sf::Font>(sptr));
+        return StylesField(std::shared_ptr<const sf::Font>(std::move(sptr)));
+    } else {
+        return StylesField();
+    }
+}
+
+std::u32string default_prewarm_characters() {
+    std::u32string rv;
+    for (char32_t c = U' '; c <= U'~'; ++c) rv += c;
+    return rv;
+}
+
+GlyphPrewarmReport prewarm_glyphs
+    (const StyleMap & smap, const std::u32string & characters)
+{
+    using Clock = std::chrono::steady_clock;
+    static constexpr const char * const k_font_size_keys[] = {
+        Frame::k_title_size, TextArea::k_text_size, TextButton::k_text_size
+    };
+    auto start = Clock::now();
+
+    std::vector<unsigned> sizes;
+    for (auto key : k_font_size_keys) {
+        auto * size = find<float>(smap, key);
+        if (!size || *size < 1.f) continue;
+        sizes.push_back(unsigned(*size));
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+
+    GlyphPrewarmReport report;
+    auto itr = smap.find(k_global_font);
+    const sf::Font * font = itr == smap.end() ? nullptr : font_from_field(itr->second);
+    if (font) {
+        for (auto size : sizes) {
+            GlyphAtlas::instance().prepare
+                (*font, size, characters.begin(), characters.end());
+        }
+        report.font_count  = 1;
+        report.size_count  = sizes.size();
+        report.glyph_count = sizes.size()*characters.size();
+    }
+    report.time = std::chrono::duration_cast<std::chrono::nanoseconds>
+        (Clock::now() - start);
+    return report;
+}
+
+StylesField load_bitmap_font(const std::string & filename) {
+    // bitmap glyphs are never added to the atlas, but layouts using them
+    // are still shared by font address
+    std::shared_ptr<BitmapFont> sptr(new BitmapFont(), [](BitmapFont * font) {
+        TextLayoutCache::instance().forget_font(font);
+        delete font;
+    });
+    if (sptr->load_from_file(filename)) {
+        return StylesField(std::shared_ptr<const BitmapFont>(std::move(sptr)));
     } else {
         return StylesField();
     }
@@ -105,3 +172,16 @@ StylesField load_font(const std::string & filename) {
 } // end of styles namespace
 
 } // end of ksg namespace
+
+namespace {
+
+const sf::Font * font_from_field(const ksg::StylesField & field) {
+    if (field.is_type<const sf::Font *>()) {
+        return field.as<const sf::Font *>();
+    } else if (field.is_type<std::shared_ptr<const sf::Font>>()) {
+        return field.as<std::shared_ptr<const sf::Font>>().get();
+    }
+    return nullptr;
+}
+
+} // end of <anonymous> namespace
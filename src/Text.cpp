@@ -47,6 +47,9 @@
 #include <common/Util.hpp>
 
 #include <ksg/DrawCharacter.hpp>
+#include <ksg/DrawBatch.hpp>
+#include <ksg/GlyphAtlas.hpp>
+#include <ksg/BitmapFont.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -64,7 +67,9 @@ using FontMtPtr              = ksg::detail::FontMtPtr;
 using TextSize               = ksg::Text::TextSize;
 using VectorF                = ksg::Text::VectorF;
 using InvalidArg             = std::invalid_argument;
-using DrawableCharacter      = ksg::detail::DrawableCharacter;
+using GlyphRecord            = ksg::detail::GlyphRecord;
+using GlyphQuad              = ksg::detail::GlyphQuad;
+using GlyphSource            = ksg::detail::GlyphSource;
 
 namespace {
 
@@ -75,12 +80,12 @@ bool is_newline   (UChar c) { return c == '\n'; }
 // we can and SHOULD test this! :)
 std::vector<UString::const_iterator> find_chunks_dividers(const UString &);
 
-void place_renderables(const sf::Font & font, const UString & ustr,
-       float width_constraint, int char_size, sf::Color color,
-       std::vector<DrawableCharacter> & renderables);
+void place_glyphs(const GlyphSource & source, const UString & ustr,
+       float width_constraint, std::vector<GlyphRecord> & glyphs,
+       std::vector<GlyphQuad> & quads);
 
-void cut_renderables(float width_constraint, float height_constraint,
-                     std::vector<DrawableCharacter> & renderables);
+void cull_glyphs(float width_constraint, float height_constraint,
+                 std::vector<GlyphRecord> & glyphs);
 
 } // end of <anonymous> namespace
 
@@ -96,7 +101,7 @@ void Text::set_string(const UString & str) {
 
 void Text::set_string(UString && str) {
     m_string.swap(str);
-    update_geometry();
+    invalidate_geometry();
 }
 
 void Text::set_limiting_width(float w) {
@@ -120,7 +125,7 @@ void Text::set_limiting_dimensions(float w, float h) {
     if (h <= 0.f) { throw InvalidArg(make_bad_dim_msg("height")); }
     m_width_constraint  = w;
     m_height_constraint = h;
-    update_geometry();
+    invalidate_geometry();
 }
 
 void Text::relieve_width_limit() {
@@ -137,17 +142,18 @@ void Text::relieve_size_limit() {
 
 void Text::set_character_size(int char_size) {
     m_char_size = char_size;
-    update_geometry();
+    invalidate_geometry();
 }
 
 void Text::set_color(sf::Color color) {
     m_color = color;
+    if (!m_colors.empty()) m_colors.front() = color;
 }
 
 void Text::set_location(float x, float y) {
+    // glyphs are placed relative to the location, so no layout is needed
     m_bounds.left = x;
     m_bounds.top = y;
-    update_geometry();
 }
 
 void Text::set_location(VectorF r) {
@@ -156,23 +162,72 @@ void Text::set_location(VectorF r) {
 
 void Text::assign_font(const sf::Font * ptr) {
     m_font_ptr = FontMtPtr(ptr);
-    update_geometry();
+    invalidate_geometry();
 }
 
 void Text::assign_font(const std::shared_ptr<const sf::Font> & ptr) {
     m_font_ptr = FontMtPtr(ptr);
-    update_geometry();
+    invalidate_geometry();
+}
+
+void Text::assign_font(const BitmapFont * ptr) {
+    m_font_ptr = FontMtPtr(ptr);
+    invalidate_geometry();
+}
+
+void Text::assign_font(const std::shared_ptr<const BitmapFont> & ptr) {
+    m_font_ptr = FontMtPtr(ptr);
+    invalidate_geometry();
 }
 
 void Text::set_color_for_character(int index, sf::Color clr) {
-    m_renderables.at(std::size_t(index)).set_color(clr);
+    refresh_geometry();
+    const auto glyph_count = layout().glyphs.size();
+    if (std::size_t(index) >= glyph_count) {
+        throw std::out_of_range("Text::set_color_for_character: index must "
+                                "be less than the number of glyphs drawn.");
+    }
+    auto itr = std::find(m_colors.begin(), m_colors.end(), clr);
+    if (itr == m_colors.end()) {
+        if (m_colors.size() == GlyphRecord::k_max_table_size) {
+            throw std::runtime_error("Text::set_color_for_character: too "
+                                     "many distinct colors in one text.");
+        }
+        itr = m_colors.insert(m_colors.end(), clr);
+    }
+    // the layout may be shared, so colors are kept apart from it
+    if (m_glyph_colors.empty()) m_glyph_colors.resize(glyph_count, 0);
+    m_glyph_colors[std::size_t(index)] =
+        GlyphRecord::IndexType(itr - m_colors.begin());
+}
+
+void Text::enable_sdf_rendering() {
+    m_sdf_requested = true;
+    invalidate_geometry();
+}
+
+void Text::disable_sdf_rendering() {
+    m_sdf_requested = false;
+    invalidate_geometry();
+}
+
+void Text::enable_shared_layout() {
+    m_share_layout = true;
+    invalidate_geometry();
+}
+
+void Text::disable_shared_layout() {
+    m_share_layout = false;
+    invalidate_geometry();
 }
 
 VectorF Text::character_location(int index) const {
-    if (m_renderables.size() == std::size_t(index)) {
+    refresh_geometry();
+    const auto & glyphs = layout().glyphs;
+    if (glyphs.size() == std::size_t(index)) {
         return location() + VectorF(m_bounds.width, 0);
-    } else if (m_renderables.size() > std::size_t(index)) {
-        return m_renderables.at(std::size_t(index)).location();
+    } else if (glyphs.size() > std::size_t(index)) {
+        return location() + glyphs[std::size_t(index)].location;
     }
     throw std::out_of_range(
         "Text::character_location: index must be [0 len], where \"len\" is "
@@ -183,22 +238,33 @@ VectorF Text::location() const {
     return VectorF(m_bounds.left, m_bounds.top);
 }
 
-float Text::width() const { return m_bounds.width; }
+float Text::width() const {
+    refresh_geometry();
+    return m_bounds.width;
+}
 
-float Text::height() const { return m_bounds.height; }
+float Text::height() const {
+    refresh_geometry();
+    return m_bounds.height;
+}
 
 float Text::line_height() const {
     if (!has_font_assigned()) return 0.f;
-    return font_ptr()->getLineSpacing(m_char_size);
+    return glyph_source().line_spacing();
 }
 
 const UString & Text::string() const
     { return m_string; }
 
 bool Text::has_font_assigned() const
-    { return font_ptr(); }
+    { return font_ptr() || bitmap_font_ptr(); }
 
 const sf::Font & Text::assigned_font() const {
+    if (bitmap_font_ptr()) {
+        throw std::runtime_error(
+            "Text::assigned_font: cannot access font, a bitmap font has been "
+            "assigned.");
+    }
     if (!font_ptr()) {
         throw std::runtime_error(
             "Text::assigned_font: cannot access font, no font has been assigned.");
@@ -206,18 +272,27 @@ const sf::Font & Text::assigned_font() const {
     return *font_ptr();
 }
 
+const BitmapFont * Text::assigned_bitmap_font() const noexcept
+    { return bitmap_font_ptr(); }
+
 int Text::character_size() const { return m_char_size; }
 
 TextSize Text::measure_text(const UString & ustring) const {
-    return measure_text(assigned_font(), m_char_size, ustring);
+    if (!has_font_assigned()) assigned_font(); // throws
+    if (m_char_size < 1) return TextSize();
+    auto source = glyph_source();
+    return TextSize { source.measure_width(ustring.begin(), ustring.end()),
+                      source.line_spacing() };
 }
 
 float Text::measure_width(UStringConstIter beg, UStringConstIter end) {
-    return Text::measure_width(assigned_font(), m_char_size, beg, end);
+    if (!has_font_assigned()) assigned_font(); // throws
+    return glyph_source().measure_width(beg, end);
 }
 
 float Text::maximum_height(UStringConstIter beg, UStringConstIter end) {
-    return Text::maximum_height(assigned_font(), m_char_size, beg, end);
+    if (!has_font_assigned()) assigned_font(); // throws
+    return glyph_source().maximum_height(beg, end);
 }
 
 bool Text::is_visible() const {
@@ -296,15 +371,31 @@ bool Text::is_visible() const {
     }
 }
 
+void Text::draw_to_batch(DrawBatch & batch) const {
+    if (!has_font_assigned()) return;
+    refresh_geometry();
+    const VectorF offset(m_bounds.left, m_bounds.top);
+    const auto * shader = glyph_source().shader();
+    const auto & layout = this->layout();
+    // clipped by trimming quads, as clipping with the batch flushes it
+    for (std::size_t i = 0; i != layout.glyphs.size(); ++i) {
+        const auto & glyph = layout.glyphs[i];
+        const auto & quad  = layout.quads[glyph.quad];
+        const auto color = m_colors[m_glyph_colors.empty() ? 0 : m_glyph_colors[i]];
+        if (layout.needs_clip) {
+            detail::add_clipped_glyph_to_batch(batch, glyph, quad, color,
+                                               layout.clip_area, offset, shader);
+        } else {
+            detail::add_glyph_to_batch(batch, glyph, quad, color, offset, shader);
+        }
+    }
+}
+
 /* private */ void Text::draw
     (sf::RenderTarget & target, sf::RenderStates states) const
 {
-    if (!has_font_assigned()) return;
-    states.texture = &font_ptr()->getTexture(unsigned(m_char_size));
-    states.transform.translate(m_bounds.left, m_bounds.top);
-    for (const auto & dc : m_renderables) {
-        target.draw(dc, states);
-    }
+    DrawBatch batch(target, states);
+    draw_to_batch(batch);
 }
 
 /* private */ const sf::Font * Text::font_ptr() const noexcept {
@@ -317,35 +408,98 @@ bool Text::is_visible() const {
     }
 }
 
-void Text::update_geometry() {
+/* private */ const BitmapFont * Text::bitmap_font_ptr() const noexcept {
+    if (m_font_ptr.is_type<const BitmapFont *>()) {
+        return m_font_ptr.as<const BitmapFont *>();
+    } else if (m_font_ptr.is_type<std::shared_ptr<const BitmapFont>>()) {
+        return m_font_ptr.as<std::shared_ptr<const BitmapFont>>().get();
+    } else {
+        return nullptr;
+    }
+}
+
+/* private */ detail::GlyphSource Text::glyph_source() const {
+    assert(has_font_assigned());
+    if (const auto * bitmap_font = bitmap_font_ptr())
+        return detail::GlyphSource(*bitmap_font, m_char_size);
+    return detail::GlyphSource(*font_ptr(), m_char_size, uses_sdf());
+}
+
+/* private */ bool Text::uses_sdf() const
+    { return m_sdf_requested && font_ptr() && GlyphAtlas::sdf_shader(); }
+
+/* private */ void Text::update_geometry() const {
+    m_geometry_dirty = false;
     if (!has_font_assigned() || m_char_size < 1 ||
-        (m_string.empty() && m_renderables.empty()))
+        (m_string.empty() && layout().glyphs.empty()))
     { return; }
 
-    place_renderables(m_renderables);
-    cut_renderables  (m_renderables);
+    // any per character colors are lost on relayout
+    m_colors.assign(1, m_color);
+    m_glyph_colors.clear();
+    if (m_share_layout) {
+        auto & cache = TextLayoutCache::instance();
+        auto key = make_layout_key();
+        m_layout = cache.find(key);
+        if (!m_layout) {
+            m_layout = make_layout();
+            cache.insert(key, m_layout);
+        }
+    } else {
+        m_layout = make_layout();
+    }
+    m_bounds.width  = m_layout->width;
+    m_bounds.height = m_layout->height;
+}
 
-    m_bounds.width = m_bounds.height = 0.f;
+/* private */ std::shared_ptr<detail::TextLayout> Text::make_layout() const {
+    auto layout = std::make_shared<detail::TextLayout>();
+    auto source = glyph_source();
+    source.prepare(m_string.begin(), m_string.end());
+    place_glyphs(source, m_string, m_width_constraint,
+                 layout->glyphs, layout->quads);
+    cull_glyphs(m_width_constraint, m_height_constraint, layout->glyphs);
 
+    float left_most   = 0.f;
+    float top_most    = 0.f;
     float right_most  = -k_inf;
     float bottom_most = -k_inf;
-    for (const auto & dc : m_renderables) {
-        right_most  = std::max(right_most , dc.location().x + dc.width ());
-        bottom_most = std::max(bottom_most, dc.location().y + dc.height());
+    for (const auto & glyph : layout->glyphs) {
+        const auto & size = layout->quads[glyph.quad].size;
+        left_most   = std::min(left_most  , glyph.location.x);
+        top_most    = std::min(top_most   , glyph.location.y);
+        right_most  = std::max(right_most , glyph.location.x + size.x);
+        bottom_most = std::max(bottom_most, glyph.location.y + size.y);
         assert(is_real(right_most) && is_real(bottom_most));
-        assert(&dc >= &m_renderables.front() && &dc <= &m_renderables.back());
     }
-    m_bounds.width  = std::max(0.f, right_most );
-    m_bounds.height = std::max(0.f, bottom_most);
-}
-
-void Text::place_renderables(std::vector<detail::DrawableCharacter> & renderables) const {
-    ::place_renderables(*font_ptr(), m_string, m_width_constraint,
-                        m_char_size, m_color, renderables);
+    layout->needs_clip =    right_most  > m_width_constraint
+                         || bottom_most > m_height_constraint;
+    layout->width  = std::max(0.f, std::min(right_most , m_width_constraint ));
+    layout->height = std::max(0.f, std::min(bottom_most, m_height_constraint));
+    layout->clip_area = sf::FloatRect(left_most, top_most,
+                                      layout->width  - left_most,
+                                      layout->height - top_most);
+    return layout;
+}
+
+/* private */ TextLayoutCache::Key Text::make_layout_key() const {
+    TextLayoutCache::Key key;
+    if (const auto * bitmap_font = bitmap_font_ptr()) {
+        key.font = bitmap_font;
+    } else {
+        key.font = font_ptr();
+    }
+    key.character_size    = m_char_size;
+    key.as_sdf            = uses_sdf();
+    key.width_constraint  = m_width_constraint;
+    key.height_constraint = m_height_constraint;
+    key.string            = m_string;
+    return key;
 }
 
-void Text::cut_renderables(std::vector<detail::DrawableCharacter> & renderables) const {
-    ::cut_renderables(m_width_constraint, m_height_constraint, renderables);
+/* private */ const detail::TextLayout & Text::layout() const noexcept {
+    static const detail::TextLayout k_empty_layout;
+    return m_layout ? *m_layout : k_empty_layout;
 }
 
 } // end of ksg namespace
@@ -371,59 +525,115 @@ std::vector<UString::const_iterator> find_chunks_dividers(const UString & ustr)
     return rv;
 }
 
-void place_renderables(const sf::Font & font, const UString & ustr,
-       float width_constraint, int char_size, sf::Color color,
-       std::vector<DrawableCharacter> & renderables)
+void place_glyphs(const GlyphSource & source, const UString & ustr,
+       float width_constraint, std::vector<GlyphRecord> & glyphs,
+       std::vector<GlyphQuad> & quads)
 {
-    renderables.clear();
+    glyphs.clear();
+    quads.clear();
 
     if (ustr.empty()) {
         // nothing to render
         return;
     }
 
-    renderables.reserve(ustr.size());
+    // same code point, same glyph, so each distinct code point is looked up
+    // only once, and the rest is arithmetic
+    struct PlacedGlyph {
+        UChar code_point;
+        // from the pen position to the quad's top left
+        VectorF offset;
+        float advance;
+        // a negative index for glyphs too small to see (e.g. spaces)
+        int quad;
+    };
+    std::vector<PlacedGlyph> placed;
+    // text which cannot be kerned needs no pair lookups
+    const bool kerned = source.has_kerning(ustr.begin(), ustr.end());
+    auto placed_for = [&](UChar c) -> const PlacedGlyph & {
+        auto itr = std::lower_bound(placed.begin(), placed.end(), c,
+            [](const PlacedGlyph & pg, UChar c) { return pg.code_point < c; });
+        if (itr != placed.end() && itr->code_point == c) return *itr;
+
+        // glyphs come from the shared atlas (or a bitmap font's pages),
+        // so text of any size may be batched together
+        const auto entry = source.glyph(c);
+        const auto & glyph = entry.glyph;
+        PlacedGlyph pg;
+        pg.code_point = c;
+        pg.offset     = VectorF(glyph.bounds.left, glyph.bounds.top + source.baseline());
+        pg.advance    = glyph.advance;
+        pg.quad       = -1;
+        if (magnitude(glyph.bounds.width ) >= 1.f &&
+            magnitude(glyph.bounds.height) >= 1.f)
+        {
+            if (quads.size() == GlyphRecord::k_max_table_size) {
+                throw std::runtime_error("Text::update_geometry: too many "
+                                         "distinct glyphs in one text.");
+            }
+            GlyphQuad quad;
+            quad.size = VectorF(glyph.bounds.width, glyph.bounds.height);
+            quad.texture_rectangle = sf::FloatRect(glyph.textureRect);
+            quad.texture = entry.texture;
+            pg.quad = int(quads.size());
+            quads.push_back(quad);
+        }
+        return *placed.insert(itr, pg);
+    };
+    auto measure_chunk = [&](UString::const_iterator beg, UString::const_iterator end) {
+        float w = 0.f;
+        for (auto itr = beg; itr != end; ++itr) {
+            w += placed_for(*itr).advance;
+            if (kerned && itr + 1 != end) w += source.kerning(*itr, *(itr + 1));
+        }
+        return w;
+    };
+
+    glyphs.reserve(ustr.size());
     VectorF write_pos;
     auto itr = ustr.begin();
     for (auto chunk_end : find_chunks_dividers(ustr)) {
         assert(itr <= chunk_end);
         if (is_newline(*itr)) {
             write_pos.x = 0.f;
-            write_pos.y += font.getLineSpacing(char_size);
+            write_pos.y += source.line_spacing();
 
             itr = chunk_end;
             continue;
         }
 
-        auto chunk_width = ksg::Text::measure_width(font, char_size, itr, chunk_end);
+        auto chunk_width = measure_chunk(itr, chunk_end);
         if (write_pos.x + chunk_width > width_constraint) {
             write_pos.x = 0.f;
-            write_pos.y += font.getLineSpacing(char_size);
+            write_pos.y += source.line_spacing();
         }
         for (auto jtr = itr; jtr != chunk_end; ++jtr) {
-            const auto & glyph = font.getGlyph(*jtr, char_size, false);
-            VectorF p(write_pos.x + glyph.bounds.left, write_pos.y + glyph.bounds.top + char_size);
-            renderables.emplace_back(p, glyph, color);
-            write_pos.x += glyph.advance;
-            if (jtr + 1 != ustr.end()) {
-                write_pos.x += font.getKerning(*jtr, *(jtr + 1), char_size);
+            const auto & pg = placed_for(*jtr);
+            if (pg.quad >= 0) {
+                GlyphRecord record;
+                record.location = write_pos + pg.offset;
+                record.quad     = GlyphRecord::IndexType(pg.quad);
+                glyphs.push_back(record);
+            }
+            write_pos.x += pg.advance;
+            if (kerned && jtr + 1 != ustr.end()) {
+                write_pos.x += source.kerning(*jtr, *(jtr + 1));
             }
         }
         itr = chunk_end;
     }
 }
 
-void cut_renderables(float width_constraint, float height_constraint,
-                     std::vector<DrawableCharacter> & renderables)
+void cull_glyphs(float width_constraint, float height_constraint,
+                 std::vector<GlyphRecord> & glyphs)
 {
-    for (auto & renderable : renderables) {
-        renderable.cut_on_bottom(height_constraint);
-        renderable.cut_on_right (width_constraint );
-    }
-    renderables.erase(
-        std::remove_if(renderables.begin(), renderables.end(),
-                       [](const DrawableCharacter & dc) { return dc.whiped_out(); }),
-        renderables.end());
+    // anything crossing a constraint is clipped when drawn
+    auto is_culled = [=](const GlyphRecord & glyph) {
+        return    glyph.location.x >= width_constraint
+               || glyph.location.y >= height_constraint;
+    };
+    glyphs.erase(std::remove_if(glyphs.begin(), glyphs.end(), is_culled),
+                 glyphs.end());
 }
 
 } // end of <anonymous> namespace
@@ -21,6 +21,7 @@
 
 #include <ksg/TextArea.hpp>
 #include <ksg/TextButton.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -149,6 +150,9 @@ void TextArea::assign_font(const sf::Font & font) {
     recompute_geometry();
 }
 
+void TextArea::draw_to_batch(DrawBatch & batch) const
+    { m_draw_text.draw_to_batch(batch); }
+
 /* protected */ void TextArea::draw
     (sf::RenderTarget & target, sf::RenderStates) const
 {
@@ -168,6 +172,7 @@ void TextArea::assign_font(const sf::Font & font) {
         text_loc.y = m_bounds.top + (m_bounds.height - m_draw_text.height()) / 2;
     }
     m_draw_text.set_location(text_loc);
+    request_redraw();
 }
 
 /* private */ void TextArea::set_max_width_no_update(float w) {
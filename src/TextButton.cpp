@@ -22,6 +22,7 @@
 #include <ksg/TextButton.hpp>
 #include <ksg/Frame.hpp>
 #include <ksg/TextArea.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -32,7 +33,10 @@ namespace ksg {
 /* static */ constexpr const char * const TextButton::k_text_color;
 /* static */ constexpr const char * const TextButton::k_text_size ;
 
-TextButton::TextButton() {}
+TextButton::TextButton() {
+    // button labels are often repeated ("OK", "Cancel"...)
+    m_text.enable_shared_layout();
+}
 
 void TextButton::swap_string(UString & str) {
     m_text.set_string(std::move(str));
@@ -64,6 +68,11 @@ void TextButton::issue_auto_resize() {
     update_string_position();
 }
 
+void TextButton::draw_to_batch(DrawBatch & batch) const {
+    Button::draw_to_batch(batch);
+    m_text.draw_to_batch(batch);
+}
+
 /* private */ void TextButton::set_size_back(float w, float h) {
     assert(w > 0.f && h > 0.f);
     update_text_geometry(w, h);
@@ -92,6 +101,7 @@ void TextButton::issue_auto_resize() {
 }
 
 /* private */ void TextButton::update_string_position() {
+    request_redraw();
     if (m_text.width() == 0.f || m_text.height() == 0.f) return;
 
     float width_diff  = width()  - padding()*2.f - m_text.width();
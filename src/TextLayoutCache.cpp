@@ -0,0 +1,109 @@
+/****************************************************************************
+
+    File: TextLayoutCache.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/TextLayoutCache.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+std::size_t combine_hashes(std::size_t seed, std::size_t hash) noexcept;
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+/* static */ constexpr const std::size_t TextLayoutCache::k_min_prune_size;
+
+bool TextLayoutCache::Key::operator == (const Key & rhs) const noexcept {
+    return font              == rhs.font              &&
+           character_size    == rhs.character_size    &&
+           as_sdf            == rhs.as_sdf            &&
+           width_constraint  == rhs.width_constraint  &&
+           height_constraint == rhs.height_constraint &&
+           string            == rhs.string;
+}
+
+/* static */ TextLayoutCache & TextLayoutCache::instance() {
+    static TextLayoutCache inst;
+    return inst;
+}
+
+TextLayoutCache::LayoutPtr TextLayoutCache::find(const Key & key) const {
+    auto itr = m_layouts.find(key);
+    if (itr == m_layouts.end()) return nullptr;
+    return itr->second.lock();
+}
+
+void TextLayoutCache::insert(const Key & key, LayoutPtr layout) {
+    if (!layout) {
+        throw std::invalid_argument("TextLayoutCache::insert: layout must "
+                                    "not be null.");
+    }
+    m_layouts[key] = layout;
+    if (m_layouts.size() < m_prune_size) return;
+    prune_unused();
+    // grows with the number of layouts in use, so pruning stays amortized
+    m_prune_size = std::max(k_min_prune_size, m_layouts.size()*2);
+}
+
+void TextLayoutCache::forget_font(const void * font) {
+    for (auto itr = m_layouts.begin(); itr != m_layouts.end(); ) {
+        if (itr->first.font == font) {
+            itr = m_layouts.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
+/* private */ std::size_t TextLayoutCache::KeyHasher::operator ()
+    (const Key & key) const noexcept
+{
+    std::size_t seed = std::hash<UString>()(key.string);
+    seed = combine_hashes(seed, std::hash<const void *>()(key.font));
+    seed = combine_hashes(seed, std::hash<int>()(key.character_size));
+    seed = combine_hashes(seed, std::hash<bool>()(key.as_sdf));
+    seed = combine_hashes(seed, std::hash<float>()(key.width_constraint));
+    seed = combine_hashes(seed, std::hash<float>()(key.height_constraint));
+    return seed;
+}
+
+/* private */ void TextLayoutCache::prune_unused() {
+    for (auto itr = m_layouts.begin(); itr != m_layouts.end(); ) {
+        if (itr->second.expired()) {
+            itr = m_layouts.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
+} // end of ksg namespace
+
+namespace {
+
+std::size_t combine_hashes(std::size_t seed, std::size_t hash) noexcept
+    { return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2)); }
+
+} // end of <anonymous> namespace
@@ -0,0 +1,116 @@
+/****************************************************************************
+
+    File: TextureCache.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/TextureCache.hpp>
+
+#include <stdexcept>
+
+#include <cassert>
+
+namespace ksg {
+
+/* static */ constexpr const std::size_t TextureCache::k_default_byte_budget;
+
+/* static */ TextureCache & TextureCache::instance() {
+    static TextureCache inst;
+    return inst;
+}
+
+/* static */ std::size_t TextureCache::estimate_bytes_of
+    (const sf::Texture & texture)
+{
+    static constexpr const std::size_t k_bytes_per_pixel = 4;
+    auto size = texture.getSize();
+    return std::size_t(size.x)*std::size_t(size.y)*k_bytes_per_pixel;
+}
+
+TextureCache::TexturePtr TextureCache::load(const std::string & filename) {
+    if (auto cached = find(filename)) return cached;
+    auto texture = std::make_shared<sf::Texture>();
+    if (!texture->loadFromFile(filename)) return nullptr;
+    return add_entry(filename, std::move(texture));
+}
+
+TextureCache::TexturePtr TextureCache::find(const std::string & filename) {
+    auto itr = m_lookup.find(filename);
+    if (itr == m_lookup.end()) return nullptr;
+    mark_used(itr->second);
+    return itr->second->texture;
+}
+
+TextureCache::TexturePtr TextureCache::insert
+    (const std::string & filename, TexturePtr texture)
+{
+    if (!texture) {
+        throw std::invalid_argument("TextureCache::insert: texture must not "
+                                    "be null.");
+    }
+    if (auto cached = find(filename)) return cached;
+    return add_entry(filename, std::move(texture));
+}
+
+void TextureCache::set_byte_budget(std::size_t byte_budget) {
+    m_byte_budget = byte_budget;
+    evict_down_to(m_byte_budget);
+}
+
+void TextureCache::evict_unused() { evict_down_to(0); }
+
+void TextureCache::clear() {
+    m_lookup.clear();
+    m_entries.clear();
+    m_bytes_used = 0;
+}
+
+/* private */ TextureCache::TexturePtr TextureCache::add_entry
+    (const std::string & filename, TexturePtr texture)
+{
+    assert(m_lookup.find(filename) == m_lookup.end());
+    Entry entry;
+    entry.filename = filename;
+    entry.bytes    = estimate_bytes_of(*texture);
+    entry.texture  = std::move(texture);
+    m_entries.push_front(std::move(entry));
+    m_lookup[filename] = m_entries.begin();
+    m_bytes_used += m_entries.front().bytes;
+    // the new entry is in use by the caller, and so is never evicted here
+    auto rv = m_entries.front().texture;
+    evict_down_to(m_byte_budget);
+    return rv;
+}
+
+/* private */ void TextureCache::mark_used(EntryList::iterator itr) {
+    m_entries.splice(m_entries.begin(), m_entries, itr);
+}
+
+/* private */ void TextureCache::evict_down_to(std::size_t byte_limit) {
+    auto itr = m_entries.end();
+    while (m_bytes_used > byte_limit && itr != m_entries.begin()) {
+        --itr;
+        // held by someone other than the cache
+        if (itr->texture.use_count() > 1) continue;
+        m_bytes_used -= itr->bytes;
+        m_lookup.erase(itr->filename);
+        itr = m_entries.erase(itr);
+    }
+}
+
+} // end of ksg namespace
@@ -20,6 +20,7 @@
 *****************************************************************************/
 
 #include <ksg/Widget.hpp>
+#include <ksg/DrawBatch.hpp>
 
 #include <stdexcept>
 
@@ -39,6 +40,15 @@ Widget::Widget(): m_visible(true) {}
 
 Widget::~Widget() {}
 
+void Widget::draw_to_batch(DrawBatch & batch) const
+    { batch.draw_unbatched(*this); }
+
+bool Widget::reset_redraw_request() const {
+    bool rv = m_redraw_requested;
+    m_redraw_requested = false;
+    return rv;
+}
+
 /* experimental */ void Widget::iterate_children(ChildWidgetIterator && itr)
     { iterate_children_(itr); }
 
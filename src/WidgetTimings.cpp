@@ -0,0 +1,186 @@
+/****************************************************************************
+
+    File: WidgetTimings.cpp
+    Author: Aria Janke
+    License: GPLv3
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <ksg/WidgetTimings.hpp>
+#include <ksg/Widget.hpp>
+
+#include <ostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <memory>
+#include <cstdlib>
+
+#ifdef __GNUG__
+#   include <cxxabi.h>
+#endif
+
+namespace {
+
+using Operation    = ksg::WidgetTimings::Operation;
+using CounterArray = ksg::WidgetTimings::CounterArray;
+
+std::string type_name_of(const ksg::Widget &);
+
+void write_json_string(std::ostream &, const std::string &);
+
+void write_json_counters(std::ostream &, const CounterArray &);
+
+void write_text_counters(std::ostream &, const CounterArray &);
+
+} // end of <anonymous> namespace
+
+namespace ksg {
+
+/* static */ constexpr const bool WidgetTimings::k_compiled_in;
+
+/* private static */ bool WidgetTimings::s_enabled = false;
+
+/* static */ WidgetTimings & WidgetTimings::instance() {
+    static WidgetTimings inst;
+    return inst;
+}
+
+/* static */ const char * WidgetTimings::operation_name(Operation op) {
+    switch (op) {
+    case k_process_event    : return "process_event"    ;
+    case k_set_style        : return "set_style"        ;
+    case k_issue_auto_resize: return "issue_auto_resize";
+    case k_finalize_widgets : return "finalize_widgets" ;
+    case k_draw             : return "draw"             ;
+    default: break;
+    }
+    throw std::invalid_argument(
+        "WidgetTimings::operation_name: operation is not a valid value.");
+}
+
+void WidgetTimings::record
+    (const Widget & widget, Operation op, std::chrono::nanoseconds time)
+{
+    auto itr = m_instances.find(&widget);
+    if (itr == m_instances.end()) {
+        // naming is the expensive part, only done once per instance
+        itr = m_instances.emplace(&widget, InstanceRecord()).first;
+        itr->second.type_name = type_name_of(widget);
+    }
+    auto & counter = itr->second.counters[std::size_t(op)];
+    ++counter.calls;
+    counter.time += time;
+}
+
+void WidgetTimings::reset() { m_instances.clear(); }
+
+WidgetTimings::TypeMap WidgetTimings::per_type() const {
+    TypeMap rv;
+    for (const auto & [ptr, rec] : m_instances) {
+        (void)ptr;
+        auto & sums = rv[rec.type_name];
+        for (std::size_t i = 0; i != sums.size(); ++i) {
+            sums[i].calls += rec.counters[i].calls;
+            sums[i].time  += rec.counters[i].time ;
+        }
+    }
+    return rv;
+}
+
+void WidgetTimings::dump_text(std::ostream & out) const {
+    out << "Per widget type:\n";
+    for (const auto & [type_name, counters] : per_type()) {
+        out << "  " << type_name << "\n";
+        write_text_counters(out, counters);
+    }
+    out << "Per widget instance:\n";
+    for (const auto & [ptr, rec] : m_instances) {
+        out << "  " << rec.type_name << " @ " << static_cast<const void *>(ptr) << "\n";
+        write_text_counters(out, rec.counters);
+    }
+}
+
+void WidgetTimings::dump_json(std::ostream & out) const {
+    out << "{\"types\":{";
+    const char * sep = "";
+    for (const auto & [type_name, counters] : per_type()) {
+        out << sep;
+        write_json_string(out, type_name);
+        out << ":";
+        write_json_counters(out, counters);
+        sep = ",";
+    }
+    out << "},\"instances\":[";
+    sep = "";
+    for (const auto & [ptr, rec] : m_instances) {
+        out << sep << "{\"address\":\"" << static_cast<const void *>(ptr)
+            << "\",\"type\":";
+        write_json_string(out, rec.type_name);
+        out << ",\"operations\":";
+        write_json_counters(out, rec.counters);
+        out << "}";
+        sep = ",";
+    }
+    out << "]}";
+}
+
+} // end of ksg namespace
+
+namespace {
+
+std::string type_name_of(const ksg::Widget & widget) {
+    const char * mangled = typeid(widget).name();
+#   ifdef __GNUG__
+    int status = 0;
+    std::unique_ptr<char, void(*)(void *)> demangled(
+        abi::__cxa_demangle(mangled, nullptr, nullptr, &status), std::free);
+    if (status == 0 && demangled) return std::string(demangled.get());
+#   endif
+    return std::string(mangled);
+}
+
+void write_json_string(std::ostream & out, const std::string & str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+void write_json_counters(std::ostream & out, const CounterArray & counters) {
+    using WidgetTimings = ksg::WidgetTimings;
+    out << "{";
+    for (std::size_t i = 0; i != counters.size(); ++i) {
+        if (i) out << ",";
+        out << "\"" << WidgetTimings::operation_name(Operation(i))
+            << "\":{\"calls\":" << counters[i].calls
+            << ",\"nanoseconds\":" << counters[i].time.count() << "}";
+    }
+    out << "}";
+}
+
+void write_text_counters(std::ostream & out, const CounterArray & counters) {
+    using WidgetTimings = ksg::WidgetTimings;
+    for (std::size_t i = 0; i != counters.size(); ++i) {
+        if (counters[i].calls == 0) continue;
+        out << "    " << WidgetTimings::operation_name(Operation(i)) << ": "
+            << counters[i].calls << " calls, "
+            << counters[i].time.count() << " ns\n";
+    }
+}
+
+} // end of <anonymous> namespace